@@ -0,0 +1,28 @@
+# Copyright (c) 2017-2021 Sébastien Rombauts (sebastien.rombauts@gmail.com)
+#
+# Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+# or copy at http://opensource.org/licenses/MIT)
+
+# Compile-time benchmark of the header-only mode against the compiled HtmlBuilder library (HTML_COMPILED_LIBRARY):
+# preprocessed size and mean compilation time of src/CompileBenchmark.cpp, compiled NB_RUNS times in each mode.
+# Usage: ./compile_benchmark.sh [NB_RUNS]   (the compiler is taken from $CXX, c++ by default)
+cd "$(dirname "$0")" || exit 1
+CXX=${CXX:-c++}
+NB_RUNS=${1:-10}
+
+for MODE in header-only compiled ; do
+    if [ "$MODE" = compiled ] ; then
+        FLAGS="-std=c++11 -O2 -Iinclude -DHTML_COMPILED_LIBRARY"
+    else
+        FLAGS="-std=c++11 -O2 -Iinclude"
+    fi
+    LINES=$($CXX $FLAGS -E src/CompileBenchmark.cpp | wc -l)
+    START=$(date +%s%N)
+    RUN=0
+    while [ $RUN -lt "$NB_RUNS" ] ; do
+        $CXX $FLAGS -c src/CompileBenchmark.cpp -o /dev/null || exit 1
+        RUN=$((RUN + 1))
+    done
+    END=$(date +%s%N)
+    echo "$MODE: $LINES preprocessed lines, $(( (END - START) / NB_RUNS / 1000000 )) ms per compilation"
+done
@@ -0,0 +1,308 @@
+/**
+ * @file    Asset.h
+ * @ingroup HtmlBuilder
+ * @brief   Inline CSS, Javascript and image Elements loaded from files, and integrity of files, cached between renders.
+ *
+ * Copyright (c) 2017-2021 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+ *
+ * Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+ * or copy at http://opensource.org/licenses/MIT)
+ */
+#pragma once
+
+#include "Element.h"
+#include "Sha2.h"
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Note: maximum number of files kept in the cache of Asset, the least recently used ones being evicted.
+#ifndef HTML_ASSET_CACHE_SIZE
+#define HTML_ASSET_CACHE_SIZE 256
+#endif
+
+/// A simple C++ HTML Generator library.
+namespace HTML {
+
+/**
+ * @brief Cache of the content of asset files to inline in the Document.
+ *
+ *   Each file is read (and encoded in base64 if requested) only once, then it is served from the cache
+ * until its modification time (to the nanosecond where the system provides it) or its size changes.
+ * Only the requested forms are cached: the data URL of an image is computed from the file directly,
+ * without keeping its raw content nor its base64 encoding besides it.
+ * The cache is shared by all threads, and protected by a mutex which is not held while reading a file,
+ * so that a large file does not block the other ones. It keeps at most HTML_ASSET_CACHE_SIZE files.
+ */
+class Asset {
+public:
+    /// Content of the file, or an empty string if it cannot be read
+    static std::shared_ptr<const std::string> content(const std::string& aPath) {
+        const std::shared_ptr<const Element> pText = text(aPath);
+        return std::shared_ptr<const std::string>(pText, &pText->content());
+    }
+
+    /// Text node with the content of the file, to insert it in Documents without any copy (see Shared)
+    static std::shared_ptr<const Element> text(const std::string& aPath) {
+        return cached(aPath, [](Entry& aEntry) -> std::shared_ptr<const Element>& {
+            return aEntry.Text;
+        }, [&aPath]() {
+            std::string content;
+            load(aPath, content);
+            return share(Text(std::move(content)));
+        });
+    }
+
+    /// Base64 encoded content of the file, or an empty string if it cannot be read
+    static std::shared_ptr<const std::string> base64(const std::string& aPath) {
+        return cached(aPath, [](Entry& aEntry) -> std::shared_ptr<const std::string>& {
+            return aEntry.Base64;
+        }, [&aPath]() {
+            std::string content;
+            load(aPath, content);
+            return std::make_shared<const std::string>(encodeBase64(content.data(), content.size()));
+        });
+    }
+
+    /// Data URL with the base64 encoded content of the file, like "data:image/png;base64,iVBORw0KGgo...",
+    /// or an empty string if it cannot be read
+    static std::shared_ptr<const std::string> dataUrl(const std::string& aPath, const std::string& aMimeType) {
+        return cached(aPath, [&aMimeType](Entry& aEntry) -> std::shared_ptr<const std::string>& {
+            return aEntry.DataUrls[aMimeType];
+        }, [&aPath, &aMimeType]() {
+            std::string content;
+            std::string url;
+            if (load(aPath, content)) {
+                url = "data:" + aMimeType + ";base64," + encodeBase64(content.data(), content.size());
+            }
+            return std::make_shared<const std::string>(std::move(url));
+        });
+    }
+
+    /**
+     * @brief Subresource Integrity of the file, like "sha384-<base64 digest>", or an empty string if it cannot be read.
+     *
+     *   The file is hashed by chunks without being kept in the cache, only its integrity is.
+     */
+    static std::shared_ptr<const std::string> integrity(const std::string& aPath, const Digest aDigest) {
+        return cached(aPath, [aDigest](Entry& aEntry) -> std::shared_ptr<const std::string>& {
+            return aEntry.Integrity[static_cast<size_t>(aDigest)];
+        }, [&aPath, aDigest]() {
+            // Only the hash of the whole file is valid: none is given if it cannot be opened or fully read
+            std::string value;
+            Sha2 sha(aDigest);
+            if (read(aPath, [&sha](const char* apData, const size_t aSize) {
+                sha.update(apData, aSize);
+            })) {
+                const std::string digest = sha.finish();
+                value = std::string(Sha2::name(aDigest)) + '-' + encodeBase64(digest.data(), digest.size());
+            }
+            return std::make_shared<const std::string>(std::move(value));
+        });
+    }
+
+    /// Empty the cache, for instance to free memory after a deployment
+    static void clear() {
+        std::lock_guard<std::mutex> lock(mutex());
+        cache().clear();
+    }
+
+    /// Encode a buffer in base64 (RFC 4648, with padding)
+    static std::string encodeBase64(const char* apData, const size_t aSize) {
+        static const char sAlphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        std::string encoded;
+        encoded.reserve(((aSize + 2) / 3) * 4);
+        const unsigned char* pData = reinterpret_cast<const unsigned char*>(apData);
+        size_t idx = 0;
+        for (; idx + 2 < aSize; idx += 3) {
+            const unsigned int bits = (static_cast<unsigned int>(pData[idx]) << 16u)
+                                    | (static_cast<unsigned int>(pData[idx + 1]) << 8u)
+                                    | static_cast<unsigned int>(pData[idx + 2]);
+            encoded += sAlphabet[(bits >> 18u) & 0x3Fu];
+            encoded += sAlphabet[(bits >> 12u) & 0x3Fu];
+            encoded += sAlphabet[(bits >> 6u) & 0x3Fu];
+            encoded += sAlphabet[bits & 0x3Fu];
+        }
+        if (idx < aSize) {
+            const unsigned int bits = (static_cast<unsigned int>(pData[idx]) << 16u)
+                                    | ((idx + 1 < aSize) ? (static_cast<unsigned int>(pData[idx + 1]) << 8u) : 0u);
+            encoded += sAlphabet[(bits >> 18u) & 0x3Fu];
+            encoded += sAlphabet[(bits >> 12u) & 0x3Fu];
+            encoded += (idx + 1 < aSize) ? sAlphabet[(bits >> 6u) & 0x3Fu] : '=';
+            encoded += '=';
+        }
+        return encoded;
+    }
+
+private:
+    /// Modification time in nanoseconds and size of a file, the size being -1 if it is not a readable regular file
+    struct Stamp {
+        long long   ModificationTime;
+        long long   Size;
+
+        bool operator==(const Stamp& aOther) const {
+            return (ModificationTime == aOther.ModificationTime) && (Size == aOther.Size);
+        }
+    };
+
+    struct Entry {
+        Stamp                                   Version;
+        unsigned long long                      LastUse;
+        std::shared_ptr<const Element>          Text;
+        std::shared_ptr<const std::string>      Base64;
+        std::unordered_map<std::string, std::shared_ptr<const std::string>> DataUrls;  ///< Indexed by MIME type
+        std::shared_ptr<const std::string>      Integrity[3];   ///< Indexed by Digest
+    };
+
+    static std::mutex& mutex() {
+        static std::mutex sMutex;
+        return sMutex;
+    }
+    static std::unordered_map<std::string, Entry>& cache() {
+        static std::unordered_map<std::string, Entry> sCache;
+        return sCache;
+    }
+
+    static Stamp stamp(const std::string& aPath) {
+        struct stat status;
+        if ((0 != stat(aPath.c_str(), &status)) || (S_IFREG != (status.st_mode & S_IFMT))) {
+            return {0, -1};
+        }
+        long long nanoseconds = 0;
+#if defined(__APPLE__)
+        nanoseconds = static_cast<long long>(status.st_mtimespec.tv_nsec);
+#elif !defined(_WIN32)
+        nanoseconds = static_cast<long long>(status.st_mtim.tv_nsec);
+#endif
+        return {static_cast<long long>(status.st_mtime) * 1000000000LL + nanoseconds,
+                static_cast<long long>(status.st_size)};
+    }
+
+    /**
+     * @brief Entry of the cache for the given version of the file (to be called with the mutex locked).
+     *
+     *   The entry is emptied if the file has changed, and the least recently used entry is evicted
+     * to make room for a new one when the cache is full.
+     */
+    static Entry& lookup(const std::string& aPath, const Stamp& aVersion) {
+        static unsigned long long sLastUse = 0;
+        std::unordered_map<std::string, Entry>& entries = cache();
+        auto found = entries.find(aPath);
+        if (found == entries.end()) {
+            if (entries.size() >= HTML_ASSET_CACHE_SIZE) {
+                auto oldest = entries.begin();
+                for (auto it = entries.begin(); it != entries.end(); ++it) {
+                    if (it->second.LastUse < oldest->second.LastUse) {
+                        oldest = it;
+                    }
+                }
+                entries.erase(oldest);
+            }
+            found = entries.insert(std::make_pair(aPath, Entry())).first;
+            found->second.Version = aVersion;
+        } else if (!(found->second.Version == aVersion)) {
+            found->second = Entry();
+            found->second.Version = aVersion;
+        }
+        found->second.LastUse = ++sLastUse;
+        return found->second;
+    }
+
+    /**
+     * @brief Value cached for the file, computed without holding the lock when it is missing.
+     *
+     * @param[in] aSelect   Give a reference to the value in an Entry
+     * @param[in] aCompute  Compute the value from the file
+     */
+    template<typename Select, typename Compute>
+    static auto cached(const std::string& aPath, Select aSelect, Compute aCompute) -> decltype(aCompute()) {
+        const Stamp version = stamp(aPath);
+        {
+            std::lock_guard<std::mutex> lock(mutex());
+            const auto& value = aSelect(lookup(aPath, version));
+            if (value) {
+                return value;
+            }
+        }
+        auto value = aCompute();
+        std::lock_guard<std::mutex> lock(mutex());
+        auto& slot = aSelect(lookup(aPath, version));
+        if (!slot) {
+            slot = std::move(value);
+        }
+        return slot;
+    }
+
+    /**
+     * @brief Read the file by chunks of 64 KiB, passed to aConsume.
+     *
+     *   The chunk is allocated on the heap, so that reading a file does not need a large stack.
+     *
+     * @return false if the file cannot be opened or an error occurred while reading it
+     */
+    template<typename Consume>
+    static bool read(const std::string& aPath, Consume aConsume) {
+        std::ifstream file(aPath, std::ios::in | std::ios::binary);
+        if (!file) {
+            return false;
+        }
+        std::vector<char> chunk(64 * 1024);
+        while (file.read(chunk.data(), static_cast<std::streamsize>(chunk.size())) || (0 < file.gcount())) {
+            aConsume(chunk.data(), static_cast<size_t>(file.gcount()));
+        }
+        return !file.bad();
+    }
+
+    /// Read the whole content of the file, left empty and returning false if it cannot be fully read
+    static bool load(const std::string& aPath, std::string& aContent) {
+        if (!read(aPath, [&aContent](const char* apData, const size_t aSize) {
+            aContent.append(apData, aSize);
+        })) {
+            aContent.clear();
+            return false;
+        }
+        return true;
+    }
+};
+
+/// \<style\> Element for inline CSS in \<head\>, with the content of a file shared with the cache of Asset
+class StyleFile : public Style {
+public:
+    explicit StyleFile(const std::string& aPath) : Style("") {
+        std::shared_ptr<const Element> pText = Asset::text(aPath);
+        if (!pText->content().empty()) {
+            addChild(Shared(std::move(pText)));
+        }
+    }
+};
+
+/// \<script\> Element for inline Javascript, with the content of a file shared with the cache of Asset
+class ScriptFile : public Script {
+public:
+    explicit ScriptFile(const std::string& aPath) : Script() {
+        std::shared_ptr<const Element> pText = Asset::text(aPath);
+        if (!pText->content().empty()) {
+            addChild(Shared(std::move(pText)));
+        }
+    }
+};
+
+/// \<img\> Image Element with the content of a file inlined as a base64 data URL, shared with the cache of Asset
+class ImageFile : public Image {
+public:
+    ImageFile(const std::string& aPath, const char* apMimeType, const std::string& aAlt,
+              unsigned int aWidth = 0, unsigned int aHeight = 0) :
+        Image(std::string(), aAlt, aWidth, aHeight) {
+        // The src attribute refers to the data URL of the cache like an interned value (see Document::intern())
+        mAttributes.front().share(Asset::dataUrl(aPath, apMimeType));
+    }
+};
+
+} // namespace HTML
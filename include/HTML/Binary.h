@@ -0,0 +1,460 @@
+/**
+ * @file    Binary.h
+ * @ingroup HtmlBuilder
+ * @brief   Compact binary image of an Element tree, to cache it or to send it to another process.
+ *
+ * Copyright (c) 2017-2021 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+ *
+ * Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+ * or copy at http://opensource.org/licenses/MIT)
+ */
+#pragma once
+
+#include "Element.h"
+#include "RenderContext.h"
+
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/// A simple C++ HTML Generator library.
+namespace HTML {
+
+/**
+ * @brief Compact binary image of an Element tree, usable in place without any parsing (for instance memory-mapped).
+ *
+ *   The image is made of a header, followed by a table of nodes in depth-first order, a table of attributes,
+ * and a table of strings pointing into a pool where each tag name, attribute and text is stored only once.
+ * All fields are 32 bits integers in the native byte order of the machine writing the image.
+ * Each node gives the index of the node following its subtree, so that the image is saved, validated,
+ * rendered and loaded in order without any recursion, whatever its depth.
+ *
+ * @verbatim
+const std::string image = HTML::Binary::save(element);  // to write to a file
+HTML::Binary binary(image.data(), image.size());        // on the memory-mapped file
+if (binary.isValid()) {
+    std::cout << binary;                                 // same HTML as std::cout << element
+    HTML::Element copy = binary.load();
+} @endverbatim
+ */
+class Binary {
+public:
+    /// Write the binary image of an Element tree (a Document is saved as its root \<html\> Element)
+    static std::string save(const Element& aElement) {
+        Writer writer;
+        writer.write(aElement);
+        return writer.image();
+    }
+
+    /**
+     * @brief View on a binary image, which must stay valid as long as this object is used.
+     *
+     *   The image is fully validated once here, so that it can then be used safely: this only allocates
+     * one index per nesting level, and images nested deeper than HTML_MAX_DEPTH are rejected.
+     */
+    Binary(const char* apData, const size_t aSize) : mpData(apData), mSize(aSize) {
+        mbValid = validate();
+    }
+
+    bool isValid() const {
+        return mbValid;
+    }
+
+    /**
+     * @brief Render the HTML of the tree directly from the image, exactly as the original Element.
+     *
+     * @throw std::length_error if the tree is nested deeper than the MaxDepth of the context
+     */
+    void render(std::string& aOutput, RenderContext& aContext) const {
+        if (!mbValid || (0 == mHeader.NbNodes)) {
+            return;
+        }
+        const size_t size = aOutput.size();
+        // Elements of which the closing tag is still to render, from the root
+        std::vector<uint32_t> open;
+        // Number of open Elements up to the <script> or <style> being rendered, the subtree of which is raw text
+        size_t rawDepth = 0;
+        RenderContext::Syntax rawSyntax = RenderContext::Syntax::Html;
+        uint32_t idx = 0;
+        while (idx < mHeader.NbNodes) {
+            while (!open.empty() && (node(open.back()).End <= idx)) {
+                renderClose(aOutput, aContext, open.back(), (open.size() - 1) * aContext.Indentation);
+                open.pop_back();
+            }
+            if (open.size() < rawDepth) {
+                rawDepth = 0;
+                rawSyntax = RenderContext::Syntax::Html;
+            }
+            if (open.size() > aContext.MaxDepth) {
+                throw std::length_error("HTML: tree nested deeper than the maximum depth");
+            }
+            const Node current = node(idx);
+            const String name = string(current.Name);
+            const RenderContext::Syntax syntax = (0 < rawDepth) ? rawSyntax : aContext.syntax(data(name), name.Size);
+            if (renderOpen(aOutput, aContext, current, open.size() * aContext.Indentation, syntax)) {
+                open.push_back(idx);
+                ++idx;
+                if ((0 == rawDepth) && (RenderContext::Syntax::Html != syntax)) {
+                    rawDepth = open.size();
+                    rawSyntax = syntax;
+                }
+            } else {
+                idx = current.End;
+            }
+        }
+        while (!open.empty()) {
+            renderClose(aOutput, aContext, open.back(), (open.size() - 1) * aContext.Indentation);
+            open.pop_back();
+        }
+        aContext.NbBytes += aOutput.size() - size;
+    }
+    friend std::ostream& operator<<(std::ostream& aStream, const Binary& aBinary) {
+        RenderContext& context = RenderContext::local();
+        context.Buffer.clear();
+        aBinary.render(context.Buffer, context);
+        return aStream.write(context.Buffer.data(), static_cast<std::streamsize>(context.Buffer.size()));
+    }
+    std::string toString() const {
+        std::string output;
+        render(output, RenderContext::local());
+        return output;
+    }
+
+    /// Convert the image back into an Element tree
+    Element load() const {
+        if (!mbValid || (0 == mHeader.NbNodes)) {
+            return Element("");
+        }
+        Element root = load(node(0));
+        // Elements still receiving their children, with the index of the end of their subtree; their vector
+        // of children is reserved to its final size, so that the pointers stay valid while it is filled
+        std::vector<std::pair<Element*, uint32_t>> open;
+        if (0 < node(0).NbChildren) {
+            open.push_back(std::make_pair(&root, node(0).End));
+        }
+        for (uint32_t idx = 1; idx < mHeader.NbNodes; ++idx) {
+            while (open.back().second <= idx) {
+                open.pop_back();
+            }
+            const Node current = node(idx);
+            std::vector<Element>& children = open.back().first->mChildren;
+            children.push_back(load(current));
+            if (0 < current.NbChildren) {
+                open.push_back(std::make_pair(&children.back(), current.End));
+            }
+        }
+        return root;
+    }
+
+private:
+    enum : uint32_t {
+        VERSION = 1,    ///< Version of the format of the image
+        FLAG_VOID = 1   ///< Flag of a self-closing Element
+    };
+
+    struct Header {
+        char        Magic[4];
+        uint32_t    Version;
+        uint32_t    NbNodes;
+        uint32_t    NbAttributes;
+        uint32_t    NbStrings;
+        uint32_t    PoolSize;
+    };
+    struct Node {
+        uint32_t    Name;
+        uint32_t    Content;
+        uint32_t    FirstAttribute;
+        uint32_t    NbAttributes;
+        uint32_t    NbChildren;
+        uint32_t    End;        ///< Index of the node following the subtree, that is the next sibling
+        uint32_t    Flags;
+    };
+    struct Attribute {
+        uint32_t    Name;
+        uint32_t    Value;
+    };
+    struct String {
+        uint32_t    Offset;
+        uint32_t    Size;
+    };
+
+    /// Build the tables of the image by walking the tree, interning each string
+    class Writer {
+    public:
+        /// Write the nodes in depth-first order, with an explicit stack instead of recursion
+        void write(const Element& aElement) {
+            // Path from the root to the current node: each Element with the index of its Node and of its next child
+            struct Frame {
+                const Element*  pElement;
+                size_t          Index;
+                size_t          Next;
+            };
+            std::vector<Frame> stack;
+            const Element* pElement = &aElement;
+            while (pElement) {
+                while (pElement->shared()) {
+                    pElement = pElement->shared();
+                }
+                const size_t index = mNodes.size();
+                mNodes.push_back(Node());
+                mNodes[index].Name = intern(pElement->mName);
+                mNodes[index].Content = intern(pElement->mContent);
+                mNodes[index].FirstAttribute = static_cast<uint32_t>(mAttributes.size());
+                mNodes[index].NbAttributes = static_cast<uint32_t>(pElement->mAttributes.size());
+                mNodes[index].NbChildren = static_cast<uint32_t>(pElement->mChildren.size());
+                mNodes[index].Flags = pElement->isVoid() ? static_cast<uint32_t>(FLAG_VOID) : 0u;
+                for (const auto& attr : pElement->mAttributes) {
+                    mAttributes.push_back({intern(attr.Name), intern(attr.value())});
+                }
+                if (pElement->mChildren.empty()) {
+                    mNodes[index].End = static_cast<uint32_t>(mNodes.size());
+                } else {
+                    stack.push_back({pElement, index, 0});
+                }
+                // Next node: the next child of the nearest ancestor not completely written
+                pElement = nullptr;
+                while (!pElement && !stack.empty()) {
+                    Frame& top = stack.back();
+                    if (top.Next < top.pElement->mChildren.size()) {
+                        pElement = &top.pElement->mChildren[top.Next++];
+                    } else {
+                        mNodes[top.Index].End = static_cast<uint32_t>(mNodes.size());
+                        stack.pop_back();
+                    }
+                }
+            }
+        }
+
+        std::string image() const {
+            Header header;
+            std::memcpy(header.Magic, "HTMB", sizeof(header.Magic));
+            header.Version = VERSION;
+            header.NbNodes = static_cast<uint32_t>(mNodes.size());
+            header.NbAttributes = static_cast<uint32_t>(mAttributes.size());
+            header.NbStrings = static_cast<uint32_t>(mStrings.size());
+            header.PoolSize = static_cast<uint32_t>(mPool.size());
+            std::string image;
+            image.reserve(sizeof(header) + mNodes.size() * sizeof(Node) + mAttributes.size() * sizeof(Attribute)
+                          + mStrings.size() * sizeof(String) + mPool.size());
+            append(image, &header, sizeof(header));
+            append(image, mNodes.data(), mNodes.size() * sizeof(Node));
+            append(image, mAttributes.data(), mAttributes.size() * sizeof(Attribute));
+            append(image, mStrings.data(), mStrings.size() * sizeof(String));
+            image += mPool;
+            return image;
+        }
+
+    private:
+        uint32_t intern(const std::string& aString) {
+            const auto inserted = mIds.insert(std::make_pair(aString, static_cast<uint32_t>(mStrings.size())));
+            if (inserted.second) {
+                mStrings.push_back({static_cast<uint32_t>(mPool.size()), static_cast<uint32_t>(aString.size())});
+                mPool += aString;
+            }
+            return inserted.first->second;
+        }
+
+        static void append(std::string& aImage, const void* apData, const size_t aSize) {
+            aImage.append(static_cast<const char*>(apData), aSize);
+        }
+
+    private:
+        std::vector<Node>                           mNodes;
+        std::vector<Attribute>                      mAttributes;
+        std::vector<String>                         mStrings;
+        std::string                                 mPool;
+        std::unordered_map<std::string, uint32_t>   mIds;
+    };
+
+    // Records are copied out of the image, which does not need to be aligned
+    Node node(const size_t aIndex) const {
+        Node node;
+        std::memcpy(&node, mpNodes + aIndex * sizeof(Node), sizeof(Node));
+        return node;
+    }
+    Attribute attribute(const size_t aIndex) const {
+        Attribute attribute;
+        std::memcpy(&attribute, mpAttributes + aIndex * sizeof(Attribute), sizeof(Attribute));
+        return attribute;
+    }
+    String string(const size_t aIndex) const {
+        String string;
+        std::memcpy(&string, mpStrings + aIndex * sizeof(String), sizeof(String));
+        return string;
+    }
+    const char* data(const String& aString) const {
+        return mpPool + aString.Offset;
+    }
+
+    bool validate() {
+        if ((nullptr == mpData) || (mSize < sizeof(Header))) {
+            return false;
+        }
+        std::memcpy(&mHeader, mpData, sizeof(Header));
+        if ((0 != std::memcmp(mHeader.Magic, "HTMB", sizeof(mHeader.Magic))) || (VERSION != mHeader.Version)) {
+            return false;
+        }
+        const unsigned long long size = sizeof(Header)
+                                      + static_cast<unsigned long long>(mHeader.NbNodes) * sizeof(Node)
+                                      + static_cast<unsigned long long>(mHeader.NbAttributes) * sizeof(Attribute)
+                                      + static_cast<unsigned long long>(mHeader.NbStrings) * sizeof(String)
+                                      + mHeader.PoolSize;
+        if (size != mSize) {
+            return false;
+        }
+        mpNodes = mpData + sizeof(Header);
+        mpAttributes = mpNodes + mHeader.NbNodes * sizeof(Node);
+        mpStrings = mpAttributes + mHeader.NbAttributes * sizeof(Attribute);
+        mpPool = mpStrings + mHeader.NbStrings * sizeof(String);
+
+        for (uint32_t idx = 0; idx < mHeader.NbStrings; ++idx) {
+            const String str = string(idx);
+            if ((str.Offset > mHeader.PoolSize) || (str.Size > mHeader.PoolSize - str.Offset)) {
+                return false;
+            }
+        }
+        for (uint32_t idx = 0; idx < mHeader.NbAttributes; ++idx) {
+            const Attribute attr = attribute(idx);
+            if ((attr.Name >= mHeader.NbStrings) || (attr.Value >= mHeader.NbStrings)) {
+                return false;
+            }
+        }
+        // Each node is followed by its children, the last one ending where the subtree of the node ends
+        for (uint32_t idx = 0; idx < mHeader.NbNodes; ++idx) {
+            const Node current = node(idx);
+            if ((current.Name >= mHeader.NbStrings) || (current.Content >= mHeader.NbStrings)
+                || (current.FirstAttribute > mHeader.NbAttributes)
+                || (current.NbAttributes > mHeader.NbAttributes - current.FirstAttribute)
+                || (current.End <= idx) || (current.End > mHeader.NbNodes)) {
+                return false;
+            }
+            uint32_t child = idx + 1;
+            for (uint32_t count = 0; count < current.NbChildren; ++count) {
+                if (child >= current.End) {
+                    return false;
+                }
+                child = node(child).End;
+            }
+            if (child != current.End) {
+                return false;
+            }
+        }
+        if ((0 < mHeader.NbNodes) && (node(0).End != mHeader.NbNodes)) {
+            return false;
+        }
+        // Depth of each node, given by the ends of the subtrees of its ancestors
+        std::vector<uint32_t> ends;
+        for (uint32_t idx = 0; idx < mHeader.NbNodes; ++idx) {
+            while (!ends.empty() && (ends.back() <= idx)) {
+                ends.pop_back();
+            }
+            if (ends.size() > HTML_MAX_DEPTH) {
+                return false;
+            }
+            ends.push_back(node(idx).End);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Render a node and its content, following the same rules as Element::render().
+     *
+     * @param[in] aSyntax   Syntax of the content, see RenderContext::syntax()
+     *
+     * @return true if the children of the node are to be rendered next, then its closing tag with renderClose()
+     */
+    bool renderOpen(std::string& aOutput, RenderContext& aContext, const Node& aNode, const size_t aIndentation,
+                    const RenderContext::Syntax aSyntax) const {
+        const String name = string(aNode.Name);
+        const String content = string(aNode.Content);
+        const bool bVoid = (0 != (aNode.Flags & FLAG_VOID));
+        ++aContext.NbNodes;
+        if (0 == name.Size) {
+            if (!bVoid) {
+                aOutput.append(aIndentation, ' ');
+                aContext.append(aOutput, data(content), content.Size, aSyntax);
+                aOutput += aContext.Endline;
+            }
+            return false;
+        }
+        aOutput.append(aIndentation, ' ');
+        aOutput += '<';
+        aOutput.append(data(name), name.Size);
+        for (uint32_t idx = aNode.FirstAttribute; idx < aNode.FirstAttribute + aNode.NbAttributes; ++idx) {
+            const Attribute attr = attribute(idx);
+            const String attrName = string(attr.Name);
+            const String attrValue = string(attr.Value);
+            aOutput += ' ';
+            aOutput.append(data(attrName), attrName.Size);
+            if (0 < attrValue.Size) {
+                aOutput += "=\"";
+                aContext.append(aOutput, data(attrValue), attrValue.Size);
+                aOutput += '"';
+            }
+        }
+        aOutput += '>';
+        if (0 < aNode.NbChildren) {
+            if (0 == content.Size) {
+                aOutput += aContext.Endline;
+            } else {
+                aContext.append(aOutput, data(content), content.Size, aSyntax);
+            }
+            return true;
+        } else if (bVoid && (0 == content.Size)) {
+            aOutput += aContext.Endline;
+            return false;
+        }
+        aContext.append(aOutput, data(content), content.Size, aSyntax);
+        aOutput += "</";
+        aOutput.append(data(name), name.Size);
+        aOutput += '>';
+        aOutput += aContext.Endline;
+        return false;
+    }
+
+    /// Render the closing tag of an Element with children
+    void renderClose(std::string& aOutput, const RenderContext& aContext, const size_t aIndex,
+                     const size_t aIndentation) const {
+        const String name = string(node(aIndex).Name);
+        aOutput.append(aIndentation, ' ');
+        aOutput += "</";
+        aOutput.append(data(name), name.Size);
+        aOutput += '>';
+        aOutput += aContext.Endline;
+    }
+
+    /// Element of a node, with its attributes but without its children
+    Element load(const Node& aNode) const {
+        const String name = string(aNode.Name);
+        const String content = string(aNode.Content);
+        Element element(std::string(data(name), name.Size).c_str(), std::string(data(content), content.Size));
+        element.mFlags.setVoid(0 != (aNode.Flags & FLAG_VOID));
+        element.mAttributes.reserve(aNode.NbAttributes);
+        for (uint32_t idx = aNode.FirstAttribute; idx < aNode.FirstAttribute + aNode.NbAttributes; ++idx) {
+            const Attribute attr = attribute(idx);
+            const String attrName = string(attr.Name);
+            const String attrValue = string(attr.Value);
+            element.mAttributes.push_back({std::string(data(attrName), attrName.Size),
+                                           std::string(data(attrValue), attrValue.Size)});
+        }
+        element.mChildren.reserve(aNode.NbChildren);
+        return element;
+    }
+
+private:
+    const char* mpData;
+    size_t      mSize;
+    bool        mbValid = false;
+    Header      mHeader = Header();
+    const char* mpNodes = nullptr;
+    const char* mpAttributes = nullptr;
+    const char* mpStrings = nullptr;
+    const char* mpPool = nullptr;
+};
+
+} // namespace HTML
@@ -0,0 +1,277 @@
+/**
+ * @file    Csv.h
+ * @ingroup HtmlBuilder
+ * @brief   Streaming conversion of a CSV or TSV file into an HTML Table.
+ *
+ * Copyright (c) 2017-2021 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+ *
+ * Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+ * or copy at http://opensource.org/licenses/MIT)
+ */
+#pragma once
+
+#include "RenderContext.h"
+
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/// A simple C++ HTML Generator library.
+namespace HTML {
+
+/**
+ * @brief Convert a CSV (RFC 4180) or TSV stream into the markup of a \<table\>, without building any Element.
+ *
+ *   The input is read in chunks of fixed size and the markup is written to the output each time the buffer
+ * of the RenderContext reaches the same size, so the memory used stays constant whatever the size of the file
+ * (apart from the longest cell). The markup is the same as the one of a Table of Row, ColHeader and Col Elements,
+ * with the characters '&', '<' and '>' of the cells escaped as entities. Empty lines are skipped.
+ *
+ * @verbatim
+std::ifstream input("report.csv", std::ios::binary);
+HTML::CsvTable().cls("table table-sm").convert(input, std::cout); @endverbatim
+ */
+class CsvTable {
+public:
+    explicit CsvTable(const char aDelimiter = ',') : mDelimiter(aDelimiter) {}
+
+    /// Character separating the cells, like ',' for CSV (default) or '\t' for TSV
+    CsvTable& delimiter(const char aDelimiter) {
+        mDelimiter = aDelimiter;
+        return *this;
+    }
+    /// Use the first record of the file as the header row, with \<th\> cells (default)
+    CsvTable& header(const bool abHeader) {
+        mbHeader = abHeader;
+        return *this;
+    }
+    CsvTable& cls(const std::string& aValue) {
+        mClass = aValue;
+        return *this;
+    }
+    /// Nesting depth of the \<table\> in the page, to indent its markup like the one of a Table at that depth
+    CsvTable& depth(const size_t aDepth) {
+        mDepth = aDepth;
+        return *this;
+    }
+    /// Size of the chunks read from the input, and of the output written at once
+    CsvTable& chunkSize(const size_t aSize) {
+        mChunkSize = (aSize > 0) ? aSize : 1;
+        return *this;
+    }
+
+    /**
+     * @brief Read the whole input and write the \<table\> markup to the output.
+     *
+     * @return Number of rows written, including the header row
+     */
+    size_t convert(std::istream& aInput, std::ostream& aOutput, RenderContext& aContext = RenderContext::local()) {
+        mpOutput = &aOutput;
+        mpContext = &aContext;
+        mIndentation = mDepth * aContext.Indentation;
+        mState = State::FieldStart;
+        mCell.clear();
+        mNbCells = 0;
+        mNbRows = 0;
+        aContext.Buffer.clear();
+
+        std::vector<char> chunk(mChunkSize);
+        while (aInput) {
+            aInput.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+            const size_t size = static_cast<size_t>(aInput.gcount());
+            if (0 == size) {
+                break;
+            }
+            parse(chunk.data(), size);
+            if (aContext.Buffer.size() >= mChunkSize) {
+                flush();
+            }
+        }
+        if ((mState != State::FieldStart) || (0 < mNbCells)) {
+            endRecord();
+        }
+
+        std::string& out = aContext.Buffer;
+        if (0 == mNbRows) {
+            openTable();
+        } else {
+            out.append(mIndentation, ' ');
+        }
+        out += "</table>";
+        out += aContext.Endline;
+        flush();
+        return mNbRows;
+    }
+
+private:
+    enum class State {
+        FieldStart, ///< Nothing read yet of the current field
+        Unquoted,   ///< Inside a field without quotes
+        Quoted,     ///< Inside a quoted field
+        QuoteQuoted ///< A quote read inside a quoted field: either the end of the field or an escaped quote
+    };
+
+    void parse(const char* apData, const size_t aSize) {
+        const char* pos = apData;
+        const char* const end = apData + aSize;
+        while (pos < end) {
+            switch (mState) {
+            case State::FieldStart:
+                if (*pos == '"') {
+                    mState = State::Quoted;
+                    ++pos;
+                    break;
+                }
+                mState = State::Unquoted;
+                // fallthrough
+            case State::Unquoted: {
+                // Copy the run of ordinary characters at once, up to the next delimiter or end of line
+                const char* stop = pos;
+                while ((stop < end) && (*stop != mDelimiter) && (*stop != '\n') && (*stop != '\r')) {
+                    ++stop;
+                }
+                mCell.append(pos, static_cast<size_t>(stop - pos));
+                pos = stop;
+                if (pos < end) {
+                    separator(*pos++);
+                }
+                break;
+            }
+            case State::Quoted: {
+                const void* quote = std::memchr(pos, '"', static_cast<size_t>(end - pos));
+                const char* stop = quote ? static_cast<const char*>(quote) : end;
+                mCell.append(pos, static_cast<size_t>(stop - pos));
+                pos = stop;
+                if (pos < end) {
+                    mState = State::QuoteQuoted;
+                    ++pos;
+                }
+                break;
+            }
+            case State::QuoteQuoted:
+                if (*pos == '"') {
+                    mCell += '"';
+                    mState = State::Quoted;
+                    ++pos;
+                } else if ((*pos == mDelimiter) || (*pos == '\n') || (*pos == '\r')) {
+                    separator(*pos++);
+                } else {
+                    // Lenient: characters after the closing quote are kept as they are
+                    mState = State::Unquoted;
+                }
+                break;
+            default:
+                break;
+            }
+        }
+    }
+
+    /// Delimiter or end of line outside of quotes
+    void separator(const char aChar) {
+        if (aChar == mDelimiter) {
+            endCell();
+            mState = State::FieldStart;
+        } else if (aChar == '\n') {
+            endRecord();
+        } else {
+            // Carriage return of a "\r\n" end of line, ignored
+            mState = (mState == State::QuoteQuoted) ? State::QuoteQuoted : State::Unquoted;
+        }
+    }
+
+    void endRecord() {
+        if ((0 == mNbCells) && mCell.empty() && (mState != State::QuoteQuoted)) {
+            mState = State::FieldStart;  // empty line
+            return;
+        }
+        endCell();
+        std::string& out = mpContext->Buffer;
+        out.append(mIndentation + mpContext->Indentation, ' ');
+        out += "</tr>";
+        out += mpContext->Endline;
+        mNbCells = 0;
+        ++mNbRows;
+        mState = State::FieldStart;
+    }
+
+    void endCell() {
+        std::string& out = mpContext->Buffer;
+        if (0 == mNbCells) {
+            if (0 == mNbRows) {
+                openTable();
+                out += mpContext->Endline;
+            }
+            out.append(mIndentation + mpContext->Indentation, ' ');
+            out += "<tr>";
+            out += mpContext->Endline;
+        }
+        const bool bHeader = mbHeader && (0 == mNbRows);
+        out.append(mIndentation + 2 * mpContext->Indentation, ' ');
+        out += bHeader ? "<th>" : "<td>";
+        escape(out);
+        out += bHeader ? "</th>" : "</td>";
+        out += mpContext->Endline;
+        mCell.clear();
+        ++mNbCells;
+    }
+
+    void openTable() {
+        std::string& out = mpContext->Buffer;
+        out.append(mIndentation, ' ');
+        out += "<table";
+        if (!mClass.empty()) {
+            out += " class=\"";
+            out += mClass;
+            out += '"';
+        }
+        out += '>';
+    }
+
+    /// Append the current cell, escaping the characters that would be taken for markup
+    void escape(std::string& aOutput) const {
+        const char* run = mCell.data();
+        const char* const end = run + mCell.size();
+        for (const char* pos = run; pos < end; ++pos) {
+            const char* entity = nullptr;
+            switch (*pos) {
+            case '&': entity = "&amp;"; break;
+            case '<': entity = "&lt;"; break;
+            case '>': entity = "&gt;"; break;
+            default: break;
+            }
+            if (entity) {
+                mpContext->append(aOutput, run, static_cast<size_t>(pos - run));
+                aOutput += entity;
+                run = pos + 1;
+            }
+        }
+        mpContext->append(aOutput, run, static_cast<size_t>(end - run));
+    }
+
+    void flush() {
+        std::string& out = mpContext->Buffer;
+        mpOutput->write(out.data(), static_cast<std::streamsize>(out.size()));
+        mpContext->NbBytes += out.size();
+        out.clear();
+    }
+
+private:
+    char            mDelimiter;
+    bool            mbHeader = true;
+    std::string     mClass;
+    size_t          mDepth = 0;
+    size_t          mChunkSize = 64 * 1024;
+
+    // State of the current conversion
+    std::ostream*   mpOutput = nullptr;
+    RenderContext*  mpContext = nullptr;
+    size_t          mIndentation = 0;   ///< Indentation of the \<table\> tags, given by the depth
+    State           mState = State::FieldStart;
+    std::string     mCell;      ///< Content of the current cell, keeping its capacity from one cell to the next
+    size_t          mNbCells = 0;
+    size_t          mNbRows = 0;
+};
+
+} // namespace HTML
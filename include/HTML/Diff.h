@@ -0,0 +1,286 @@
+/**
+ * @file    Diff.h
+ * @ingroup HtmlBuilder
+ * @brief   Minimal list of edit operations between two trees of the HTML Document Object Model.
+ *
+ * Copyright (c) 2017-2021 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+ *
+ * Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+ * or copy at http://opensource.org/licenses/MIT)
+ */
+#pragma once
+
+#include "Element.h"
+
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/// A simple C++ HTML Generator library.
+namespace HTML {
+
+/**
+ * @brief Compute the edit operations turning an Element tree into another one, for instance to update a live page.
+ *
+ *   A hash of each subtree is computed first, so that unchanged subtrees are skipped without being compared.
+ * Children are matched on their "id" attribute when they have one, and by position otherwise;
+ * matched children that do not keep their relative order are removed and inserted again.
+ * The cost is near-linear in the number of nodes, and the trees are walked with explicit stacks instead of recursion.
+ *
+ *   The patches are to be applied in order: the Path of each one is the list of child indexes from the root,
+ * in the tree as modified by the previous patches.
+ */
+class Diff {
+public:
+    /// Edit operation to apply to the old tree
+    struct Patch {
+        enum class Operation {
+            Insert,         ///< Insert the HTML given in Value as the child at Path
+            Remove,         ///< Remove the child at Path
+            Replace,        ///< Replace the node at Path by the HTML given in Value
+            Text,           ///< Replace the content of the node at Path (the text before its children) by Value
+            SetAttribute,   ///< Set the attribute Name of the Element at Path to Value
+            RemoveAttribute ///< Remove the attribute Name of the Element at Path
+        };
+
+        Operation           Op;
+        std::vector<size_t> Path;
+        std::string         Name;
+        std::string         Value;
+    };
+
+    /// Compute the list of patches to apply to aOld to obtain aNew
+    static std::vector<Patch> compute(const Element& aOld, const Element& aNew) {
+        Diff diff;
+        diff.hash(aOld);
+        diff.hash(aNew);
+        diff.compare(resolve(aOld), resolve(aNew));
+        return std::move(diff.mPatches);
+    }
+
+private:
+    /// Node of the new tree to compare with its match in the old tree, or to insert if pOld is nullptr
+    struct Task {
+        const Element*  pOld;
+        const Element*  pNew;
+        size_t          Depth;  ///< Length of the Path of the node
+        size_t          Index;  ///< Last index of the Path of the node
+    };
+
+    /// The Element actually rendered, following references to Shared subtrees
+    static const Element& resolve(const Element& aElement) {
+        const Element* pElement = &aElement;
+        while (pElement->shared()) {
+            pElement = pElement->shared();
+        }
+        return *pElement;
+    }
+
+    static void combine(size_t& aSeed, const size_t aValue) {
+        aSeed ^= aValue + 0x9e3779b9u + (aSeed << 6u) + (aSeed >> 2u);
+    }
+
+    /// Hash of a node itself, without its children
+    static size_t seed(const Element& aElement) {
+        const std::hash<std::string> hasher;
+        size_t seed = hasher(aElement.mName);
+        combine(seed, hasher(aElement.mContent));
+        combine(seed, aElement.isVoid() ? 1u : 0u);
+        for (const auto& attr : aElement.mAttributes) {
+            combine(seed, hasher(attr.Name));
+            combine(seed, hasher(attr.value()));
+        }
+        return seed;
+    }
+
+    /// Hash of each subtree, memorized for each node (only once for each Shared subtree), after its children
+    void hash(const Element& aRoot) {
+        // Path from the root to the current node, each with the index of its next child and its partial hash
+        struct Frame {
+            const Element*  pElement;
+            size_t          Next;
+            size_t          Seed;
+        };
+        const Element& root = resolve(aRoot);
+        if (mHashes.find(&root) != mHashes.end()) {
+            return;
+        }
+        std::vector<Frame> stack(1, Frame{&root, 0, seed(root)});
+        while (!stack.empty()) {
+            Frame& top = stack.back();
+            if (top.Next < top.pElement->mChildren.size()) {
+                const Element& child = resolve(top.pElement->mChildren[top.Next++]);
+                const auto found = mHashes.find(&child);
+                if (found != mHashes.end()) {
+                    combine(top.Seed, found->second);
+                } else {
+                    stack.push_back(Frame{&child, 0, seed(child)});
+                }
+            } else {
+                const size_t value = top.Seed;
+                mHashes[top.pElement] = value;
+                stack.pop_back();
+                if (!stack.empty()) {
+                    combine(stack.back().Seed, value);
+                }
+            }
+        }
+    }
+
+    /// Value of the "id" attribute used to match children, or nullptr
+    static const std::string* key(const Element& aElement) {
+        for (const auto& attr : aElement.mAttributes) {
+            if (attr.Name == "id") {
+                return &attr.value();
+            }
+        }
+        return nullptr;
+    }
+
+    void add(const Patch::Operation aOp, const std::vector<size_t>& aPath,
+             const std::string& aName = std::string(), const std::string& aValue = std::string()) {
+        mPatches.push_back({aOp, aPath, aName, aValue});
+    }
+
+    /**
+     * @brief Compare the trees depth-first, in the order of the recursive algorithm, with an explicit stack of tasks.
+     *
+     *   When a task is popped, the current path is the path of its parent followed by deeper nodes already done,
+     * so that its own path is this prefix followed by its index.
+     */
+    void compare(const Element& aOld, const Element& aNew) {
+        std::vector<size_t> path;
+        std::vector<Task> tasks(1, Task{&aOld, &aNew, 0, 0});
+        while (!tasks.empty()) {
+            const Task task = tasks.back();
+            tasks.pop_back();
+            if (0 < task.Depth) {
+                path.resize(task.Depth - 1);
+                path.push_back(task.Index);
+            }
+            if (task.pOld) {
+                compare(*task.pOld, *task.pNew, path, tasks);
+            } else {
+                add(Patch::Operation::Insert, path, std::string(), task.pNew->toString());
+            }
+        }
+    }
+
+    /// Compare two nodes, adding the tasks of their children to compare or insert
+    void compare(const Element& aOld, const Element& aNew, std::vector<size_t>& aPath, std::vector<Task>& aTasks) {
+        if (mHashes[&aOld] == mHashes[&aNew]) {
+            return;
+        }
+        if ((aOld.mName != aNew.mName) || (aOld.isVoid() != aNew.isVoid())) {
+            add(Patch::Operation::Replace, aPath, std::string(), aNew.toString());
+            return;
+        }
+        if (aOld.mContent != aNew.mContent) {
+            add(Patch::Operation::Text, aPath, std::string(), aNew.mContent);
+        }
+        if (!aNew.mName.empty()) {
+            compareAttributes(aOld, aNew, aPath);
+            compareChildren(aOld, aNew, aPath, aTasks);
+        }
+    }
+
+    void compareAttributes(const Element& aOld, const Element& aNew, const std::vector<size_t>& aPath) {
+        // As when parsing HTML, only the first occurrence of an attribute is taken into account
+        std::unordered_map<std::string, const std::string*> oldValues;
+        for (const auto& attr : aOld.mAttributes) {
+            oldValues.insert(std::make_pair(attr.Name, &attr.value()));
+        }
+        std::unordered_map<std::string, const std::string*> newValues;
+        for (const auto& attr : aNew.mAttributes) {
+            if (newValues.insert(std::make_pair(attr.Name, &attr.value())).second) {
+                const auto found = oldValues.find(attr.Name);
+                if ((found == oldValues.end()) || (*found->second != attr.value())) {
+                    add(Patch::Operation::SetAttribute, aPath, attr.Name, attr.value());
+                }
+            }
+        }
+        for (const auto& attr : aOld.mAttributes) {
+            if ((newValues.find(attr.Name) == newValues.end()) && (oldValues.erase(attr.Name) > 0)) {
+                add(Patch::Operation::RemoveAttribute, aPath, attr.Name);
+            }
+        }
+    }
+
+    void compareChildren(const Element& aOld, const Element& aNew, std::vector<size_t>& aPath,
+                         std::vector<Task>& aTasks) {
+        const std::vector<Element>& olds = aOld.mChildren;
+        const std::vector<Element>& news = aNew.mChildren;
+        const size_t none = olds.size();
+
+        // Match new children to old ones, on their id or else by position among children without id
+        std::unordered_map<std::string, size_t> keyed;
+        std::vector<size_t> unkeyed;
+        for (size_t idx = 0; idx < olds.size(); ++idx) {
+            const std::string* pKey = key(resolve(olds[idx]));
+            if (!pKey || !keyed.insert(std::make_pair(*pKey, idx)).second) {
+                unkeyed.push_back(idx);
+            }
+        }
+        std::vector<size_t> matches(news.size(), none);
+        size_t nextUnkeyed = 0;
+        for (size_t idx = 0; idx < news.size(); ++idx) {
+            const std::string* pKey = key(resolve(news[idx]));
+            if (pKey) {
+                const auto found = keyed.find(*pKey);
+                if (found != keyed.end()) {
+                    matches[idx] = found->second;
+                    keyed.erase(found);
+                }
+            } else if (nextUnkeyed < unkeyed.size()) {
+                matches[idx] = unkeyed[nextUnkeyed++];
+            }
+        }
+
+        // Keep the longest subsequence of matches in the same order in both trees
+        std::vector<size_t> tails;  // index in news of the last match of the best subsequence of each length
+        std::vector<size_t> previous(news.size(), news.size());
+        for (size_t idx = 0; idx < news.size(); ++idx) {
+            if (matches[idx] != none) {
+                const auto pos = std::lower_bound(tails.begin(), tails.end(), idx, [&](size_t aLeft, size_t aRight) {
+                    return matches[aLeft] < matches[aRight];
+                });
+                if (pos != tails.begin()) {
+                    previous[idx] = *(pos - 1);
+                }
+                if (pos == tails.end()) {
+                    tails.push_back(idx);
+                } else {
+                    *pos = idx;
+                }
+            }
+        }
+        std::vector<bool> keptNew(news.size(), false);
+        std::vector<bool> keptOld(olds.size(), false);
+        for (size_t idx = tails.empty() ? news.size() : tails.back(); idx < news.size(); idx = previous[idx]) {
+            keptNew[idx] = true;
+            keptOld[matches[idx]] = true;
+        }
+
+        // Remove old children from the last one so that indexes stay valid, then insert or compare new ones in order
+        for (size_t idx = olds.size(); idx > 0; --idx) {
+            if (!keptOld[idx - 1]) {
+                aPath.push_back(idx - 1);
+                add(Patch::Operation::Remove, aPath);
+                aPath.pop_back();
+            }
+        }
+        for (size_t idx = news.size(); idx > 0; --idx) {
+            const Element* pOld = keptNew[idx - 1] ? &resolve(olds[matches[idx - 1]]) : nullptr;
+            aTasks.push_back(Task{pOld, &resolve(news[idx - 1]), aPath.size() + 1, idx - 1});
+        }
+    }
+
+private:
+    std::unordered_map<const Element*, size_t>  mHashes;
+    std::vector<Patch>                          mPatches;
+};
+
+} // namespace HTML
@@ -0,0 +1,23 @@
+/**
+ * @file    Digest.h
+ * @ingroup HtmlBuilder
+ * @brief   Hash algorithms of Subresource Integrity.
+ *
+ * Copyright (c) 2017-2021 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+ *
+ * Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+ * or copy at http://opensource.org/licenses/MIT)
+ */
+#pragma once
+
+/// A simple C++ HTML Generator library.
+namespace HTML {
+
+/// Hash algorithm of a Subresource Integrity, see Script::integrityFromFile()
+enum class Digest {
+    Sha256,
+    Sha384,
+    Sha512
+};
+
+} // namespace HTML
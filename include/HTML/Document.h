@@ -12,9 +12,12 @@
 
 #include "Element.h"
 
-#include <sstream>
+#include <iosfwd>
+#include <memory>
+#include <stdexcept>
 #include <string>
 #include <utility>
+#include <vector>
 
 /// A simple C++ HTML Generator library.
 namespace HTML {
@@ -35,71 +38,183 @@ namespace HTML {
  */
 class Document : public Element {
 public:
-    Document() :
-        Element(), mHead(*static_cast<Head*>(&mChildren[0])), mBody(*static_cast<Body*>(&mChildren[1])) {
+    Document() : Element() {
     }
-    explicit Document(const char* apTitle) :
-        Element(), mHead(*static_cast<Head*>(&mChildren[0])), mBody(*static_cast<Body*>(&mChildren[1])) {
-        mHead << HTML::Title(apTitle);
+    explicit Document(const char* apTitle) : Element() {
+        head() << HTML::Title(apTitle);
     }
-    explicit Document(const std::string& aTitle) :
-        Element(), mHead(*static_cast<Head*>(&mChildren[0])), mBody(*static_cast<Body*>(&mChildren[1])) {
-        mHead << HTML::Title(aTitle);
+    explicit Document(const std::string& aTitle) : Element() {
+        head() << HTML::Title(aTitle);
     }
-    Document(const char* apTitle, Style&& aStyle) :
-        Element(), mHead(*static_cast<Head*>(&mChildren[0])), mBody(*static_cast<Body*>(&mChildren[1])) {
-        mHead << HTML::Title(apTitle);
-        mHead << std::move(aStyle);
+    Document(const char* apTitle, Style&& aStyle) : Element() {
+        head() << HTML::Title(apTitle);
+        head() << std::move(aStyle);
     }
-    Document(const char* apTitle, const Style& aStyle) :
-        Element(), mHead(*static_cast<Head*>(&mChildren[0])), mBody(*static_cast<Body*>(&mChildren[1])) {
-        mHead << HTML::Title(apTitle);
-        mHead << Style(aStyle);
+    Document(const char* apTitle, const Style& aStyle) : Element() {
+        head() << HTML::Title(apTitle);
+        head() << Style(aStyle);
     }
+    /**
+     * @brief Variant of a base Document made immutable with share(), without copying its content.
+     *
+     *   Only the \<html\>, \<head\> and \<body\> nodes are copied, each top-level child remaining a reference
+     * to the one of the base. Element::child() then copies only the nodes on the path to the ones modified,
+     * see Element::unshare(): many variants of a large page cost little more memory than the page itself.
+     * The base is never modified, and can be shared by variants built and rendered on other threads.
+     *
+     * @throw std::invalid_argument if the base is not an \<html\> root with its \<head\> and \<body\>
+     */
+    explicit Document(const std::shared_ptr<const Element>& apBase) : Element(Shared(apBase)) {
+        unshare();
+        if ((mName != "html") || (mChildren.size() != 2)
+            || (child(0).name() != "head") || (child(1).name() != "body")) {
+            throw std::invalid_argument("HTML: the base of a Document variant is not a Document");
+        }
+    }
+
+    // A copy gets its own intern pool, so that two copies can be interned by different threads at the same time:
+    // the values already interned stay shared, each kept alive by the references to it
+    Document(const Document& aOther) :
+        Element(aOther), mHoistedStyles(aOther.mHoistedStyles), mHoistedStyle(aOther.mHoistedStyle) {}
+    Document(Document&& aOther) = default;
+    Document& operator=(const Document& aOther) {
+        if (this != &aOther) {
+            Element::operator=(aOther);
+            mpPool.reset();
+            mHoistedStyles = aOther.mHoistedStyles;
+            mHoistedStyle = aOther.mHoistedStyle;
+        }
+        return *this;
+    }
+    Document& operator=(Document&& aOther) = default;
 
     Document& operator<<(Element&& aElement) {
-        mBody << std::move(aElement);
+        body() << std::move(aElement);
+        return *this;
+    }
+
+    /// First child Element \<head\>, looked up each time so that it stays valid when the Document is copied or moved
+    Head& head() {
+        return *static_cast<Head*>(&mChildren[0]);
+    }
+    /// Second child Element \<body\>
+    Body& body() {
+        return *static_cast<Body*>(&mChildren[1]);
+    }
+
+    /// Reserve room for the given number of children of the \<body\>, where operator<< adds them
+    Document& reserve(const size_t aNbChildren) {
+        body().reserve(aNbChildren);
         return *this;
     }
 
-    Element& head() {
-        return mHead;
+    /// Append a piece of text to the \<body\>, see Element::append()
+    Document& append(const char* apText, const size_t aSize) {
+        body().append(apText, aSize);
+        return *this;
+    }
+    Document& append(const char* apText) {
+        body().append(apText);
+        return *this;
+    }
+    Document& append(const std::string& aText) {
+        body().append(aText);
+        return *this;
     }
-    Element& body() {
-        return mBody;
+    /// Reserve room in the text buffer of the \<body\> used by the next append()
+    Document& reserveText(const size_t aSize) {
+        body().reserveText(aSize);
+        return *this;
+    }
+
+    /// Append empty child slots to the \<body\>, see Element::addSlots()
+    size_t addSlots(const size_t aNbSlots) {
+        return body().addSlots(aNbSlots);
+    }
+    /// Child slot of the \<body\> at the given index
+    Slot<Element> slot(const size_t aIndex) {
+        return body().slot(aIndex);
+    }
+
+    /**
+     * @brief Remove all the content of the \<body\>, keeping the \<head\> and the capacity of the body.
+     *
+     *   This enables a thread to reuse the same Document to build page after page without reallocating
+     * the vector of the top-level children of the \<body\> each time. Only that vector (and the content
+     * and attributes of the \<body\>) keeps its capacity: the removed Elements are freed with all their buffers,
+     * unless a NodePool is in scope to recycle them for the next page (see NodePool.h).
+     */
+    void clear() {
+        body().clear();
+    }
+
+    /**
+     * @brief Hoist inline style values repeated on several Elements into a \<style\> block of the \<head\>.
+     *
+     *   Each style value used more than once is replaced by a generated class (apPrefix followed by a number)
+     * added to the class attribute of the Elements, and the corresponding CSS rules are added to a \<style\>
+     * of the \<head\>. Values are counted then replaced in two passes over the tree using hash maps,
+     * so it runs in linear time. It can be called again after adding more Elements: the classes generated
+     * by the previous calls are reused for their values, even used only once, and the new rules are appended
+     * to the same \<style\>. Include Styles.h to use it.
+     *
+     *   Note: a class rule has a lower priority than an inline style. If the page has its own style sheet
+     * with rules applying to the same Elements, a hoisted property can now be overridden by one of these rules,
+     * the same as if it had been written in a style sheet in the first place.
+     *
+     * @param[in] apPrefix  Prefix of the generated class names, to avoid conflicts with existing classes
+     */
+    template<typename Hoister = StyleHoister>
+    void hoistStyles(const char* apPrefix = "hb-") {
+        Hoister::hoist(*this, apPrefix);
+    }
+
+    /**
+     * @brief Store the attribute values repeated across the Document only once, in an intern pool.
+     *
+     *   Each attribute value of at least aMinSize bytes currently in the Document is moved to a pool
+     * shared by the whole Document, the attributes keeping a reference to it. Each copy of the Document
+     * has its own pool, so that copies can be interned concurrently. Long values repeated thousands
+     * of times (class lists, URLs, integrity hashes...) are then allocated only once.
+     * Call it again after adding more Elements; shorter values already fit in std::string without allocation.
+     * Include Intern.h to use it.
+     *
+     * @param[in] aMinSize  Minimum size of the values to intern
+     */
+    template<typename Pool = InternPool>
+    void intern(const size_t aMinSize = 16) {
+        Pool::intern(*this, mpPool, aMinSize);
     }
 
     void lang(const char* apLang) {
-        mHead.addAttribute("lang", apLang);
+        head().addAttribute("lang", apLang);
     }
 
     friend std::ostream& operator<< (std::ostream& aStream, const Document& aElement);
 
-    std::string toString() const {
-        std::ostringstream stream;
-        stream << *this;
-        return stream.str();
-    }
+    std::string toString() const;
+
+    /// Render the HTML, with the DOCTYPE, at the end of the output string with the given context
+    void render(std::string& aOutput, RenderContext& aContext) const;
 
     operator std::string() const {
         return toString();
     }
 
 private:
-    std::ostream& toString(std::ostream& aStream) const {
-        aStream << "<!DOCTYPE html>" HTML_ENDLINE;
-        Element::toString(aStream);
-        return aStream;
-    }
+    friend class StyleHoister;
 
-private:
-    Head& mHead; ///< Reference to the first child Element \<head\>
-    Body& mBody; ///< Reference to the second child Element \<body\>
+    std::shared_ptr<InternPool> mpPool;     ///< Attribute values interned by intern()
+    /// Style value and generated class of each style hoisted by hoistStyles(), numbered in this order
+    std::vector<std::pair<std::string, std::string>> mHoistedStyles;
+    size_t mHoistedStyle = 0;   ///< Position in the \<head\> of the \<style\> of the hoisted styles
 };
 
-inline std::ostream& operator<< (std::ostream& aStream, const Document& aDocument) {
-    return aDocument.toString(aStream);
-}
+HTML_INLINE std::ostream& operator<< (std::ostream& aStream, const Document& aDocument);
 
 } // namespace HTML
 
+#ifndef HTML_COMPILED_LIBRARY
+#include "Document.inl"
+#endif
+
@@ -0,0 +1,47 @@
+/**
+ * @file    Document.inl
+ * @ingroup HtmlBuilder
+ * @brief   Serialization of the root Element of the HTML Document Object Model.
+ *
+ *   Included by Document.h in header-only mode, or compiled once in the HtmlBuilder library
+ * when HTML_COMPILED_LIBRARY is defined.
+ *
+ * Copyright (c) 2017-2021 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+ *
+ * Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+ * or copy at http://opensource.org/licenses/MIT)
+ */
+#pragma once
+
+#include "Document.h"
+#include "Element.inl"
+#include "RenderContext.h"
+
+#include <ostream>
+#include <string>
+
+/// A simple C++ HTML Generator library.
+namespace HTML {
+
+HTML_INLINE std::ostream& operator<< (std::ostream& aStream, const Document& aDocument) {
+    RenderContext& context = RenderContext::local();
+    context.Buffer.clear();
+    aDocument.render(context.Buffer, context);
+    return aStream.write(context.Buffer.data(), static_cast<std::streamsize>(context.Buffer.size()));
+}
+
+HTML_INLINE std::string Document::toString() const {
+    std::string output;
+    render(output, RenderContext::local());
+    return output;
+}
+
+HTML_INLINE void Document::render(std::string& aOutput, RenderContext& aContext) const {
+    const size_t size = aOutput.size();
+    aOutput += "<!DOCTYPE html>";
+    aOutput += aContext.Endline;
+    aContext.NbBytes += aOutput.size() - size;
+    Element::render(aOutput, aContext);
+}
+
+} // namespace HTML
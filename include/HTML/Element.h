@@ -10,11 +10,15 @@
  */
 #pragma once
 
-#include <sstream>
+#include "Digest.h"
+
+#include <cstdint>
+#include <iosfwd>
 #include <string>
 #include <vector>
-#include <algorithm>
-#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
 #include <utility>
 
 /// A simple C++ HTML Generator library.
@@ -27,6 +31,25 @@ namespace HTML {
 #ifndef HTML_ENDLINE
 #define HTML_ENDLINE "\n"
 #endif
+// Note: maximum nesting depth accepted when visiting or rendering a tree, see Element::visit().
+#ifndef HTML_MAX_DEPTH
+#define HTML_MAX_DEPTH 100000
+#endif
+
+// Note: define HTML_COMPILED_LIBRARY to link with the compiled HtmlBuilder library instead of the header-only mode;
+// indentation & minification are then configured when compiling the library.
+#ifdef HTML_COMPILED_LIBRARY
+#define HTML_INLINE
+#else
+#define HTML_INLINE inline
+#endif
+
+class RenderContext;
+class Asset;
+class Options;
+class InternPool;
+class StyleHoister;
+class NodePool;
 
 /// Convert a boolean to string like std::boolalpha in a std::ostream
 constexpr const char* to_string(bool aBool) {
@@ -41,28 +64,51 @@ constexpr const char* to_string(bool aBool) {
 class Element {
 public:
     explicit Element(const char* apName, const char* apContent = nullptr) :
-        mName(apName), mContent(apContent ? apContent : "") {}
+        mName(apName), mContent(newString(apContent ? apContent : "")) {}
     Element(const char* apName, std::string&& aContent) :
-        mName(apName), mContent(aContent) {}
+        mName(apName), mContent(std::move(aContent)) {}
     Element(const char* apName, const std::string& aContent) :
-        mName(apName), mContent(aContent) {}
+        mName(apName), mContent(newString(aContent.data(), aContent.size())) {}
+
+    // Copying and destroying a tree use an explicit stack instead of recursion, so that the depth of the tree
+    // is not limited by the size of the call stack; moves only transfer the vector of children
+    Element(const Element& aOther);
+    Element(Element&& aOther) = default;
+    Element& operator=(const Element& aOther) {
+        if (this != &aOther) {
+            *this = Element(aOther);
+        }
+        return *this;
+    }
+    Element& operator=(Element&& aOther) = default;
+    ~Element() {
+        if (!mChildren.empty()) {
+            releaseChildren();
+        }
+        if (nullptr != recycler()) {
+            recycle();
+        }
+    }
 
     Element&& addAttribute(const char* apName, const char* apValue) {
         if (apName && apValue) {
-            mAttributes.push_back({ apName, apValue });
+            makeRoom(mAttributes);
+            mAttributes.push_back({apName, newString(apValue)});
         }
         return std::move(*this);
     }
     Element&& addAttribute(const char* apName, const std::string& aValue) {
-        mAttributes.push_back({apName, aValue});
+        makeRoom(mAttributes);
+        mAttributes.push_back({apName, newString(aValue.data(), aValue.size())});
         return std::move(*this);
     }
     Element&& addAttribute(const char* apName, const unsigned int aValue) {
+        makeRoom(mAttributes);
         mAttributes.push_back({apName, std::to_string(aValue)});
         return std::move(*this);
     }
     Element&& operator<<(Element&& aElement) {
-        mChildren.push_back(std::move(aElement));
+        addChild(std::move(aElement));
         return std::move(*this);
     }
     Element&& operator<<(const char* apContent);
@@ -70,11 +116,16 @@ public:
     Element&& operator<<(const std::string& aContent);
 
     friend std::ostream& operator<<(std::ostream& aStream, const Element& aElement);
-    std::string toString() const {
-        std::ostringstream stream;
-        stream << *this;
-        return stream.str();
-    }
+    friend class Diff;
+    friend class Binary;
+    friend class Index;
+    friend class InternPool;
+    friend class StyleHoister;
+    friend class NodePool;
+    std::string toString() const;
+
+    /// Render the HTML at the end of the output string, with the options and the buffers of the given context
+    void render(std::string& aOutput, RenderContext& aContext) const;
 
     Element&& id(const char* apValue) {
         return addAttribute("id", apValue);
@@ -104,71 +155,400 @@ public:
         return addAttribute("style", aValue);
     }
 
+    /// Reserve room for the given number of children, to avoid reallocations when their number is known in advance
+    Element&& reserve(const size_t aNbChildren) {
+        if ((aNbChildren > mChildren.capacity()) && (nullptr != recycler())) {
+            recycler()->grow(mChildren, aNbChildren);
+        }
+        mChildren.reserve(aNbChildren);
+        return std::move(*this);
+    }
+
+    /**
+     * @brief Append a piece of text to the last text of the Element, instead of adding a new Text child.
+     *
+     *   The text goes to the content of the Element while it has no children, or else to its last child
+     * if it is a Text node, and only otherwise to a new Text child. Consecutive pieces are thus concatenated
+     * in one buffer, without the line break that separates the Text children added by operator<<.
+     */
+    Element&& append(const char* apText, const size_t aSize) {
+        textBuffer().append(apText, aSize);
+        return std::move(*this);
+    }
+    Element&& append(const char* apText) {
+        textBuffer().append(apText);
+        return std::move(*this);
+    }
+    Element&& append(const std::string& aText) {
+        textBuffer().append(aText);
+        return std::move(*this);
+    }
+
+    /// Reserve room in the text buffer used by the next append(), when the total size of the pieces is known
+    Element&& reserveText(const size_t aSize) {
+        std::string& buffer = textBuffer();
+        buffer.reserve(buffer.size() + aSize);
+        return std::move(*this);
+    }
+
+    /**
+     * @brief Child slot of an Element, filled by assigning it an Element that the parent accepts as a child.
+     *
+     *   Until then, the slot is a placeholder rendering nothing. A slot cannot be built in place:
+     * build its Element first, then move it into the slot.
+     */
+    template<typename Parent>
+    class Slot {
+    public:
+        explicit Slot(Element& aElement) : mElement(aElement) {}
+
+        template<typename Child,
+                 typename = typename std::enable_if<std::is_base_of<Element, Child>::value>::type,
+                 typename = decltype(std::declval<Parent>() << std::declval<Child>())>
+        Slot& operator=(Child&& aChild) {
+            mElement = std::move(aChild);
+            return *this;
+        }
+
+    private:
+        Element& mElement;
+    };
+
+    /**
+     * @brief Append empty child slots, to be filled later with slot(), in the order of their index.
+     *
+     *   Each slot can be filled by a different thread without any lock, as long as the Element itself
+     * is not modified in the meantime. A slot left empty renders nothing.
+     *
+     * @param[in] aNbSlots  Number of slots to append
+     *
+     * @return Index of the first slot
+     */
+    size_t addSlots(const size_t aNbSlots) {
+        const size_t first = mChildren.size();
+        Element placeholder("");
+        placeholder.mFlags.setVoid(true);
+        mChildren.resize(first + aNbSlots, placeholder);
+        return first;
+    }
+    /// Child slot at the given index, to assign an Element to
+    Slot<Element> slot(const size_t aIndex) {
+        return Slot<Element>(mChildren[aIndex]);
+    }
+
+    /// Remove content, attributes and children, but keep the allocated capacity so that the Element can be reused
+    void clear() {
+        mContent.clear();
+        mAttributes.clear();
+        mChildren.clear();
+    }
+
+    /**
+     * @brief Attribute of an Element, holding either its own value or a reference to a value stored once elsewhere.
+     *
+     *   Both share the same storage, so that an interned attribute (see Document::intern()) does not keep
+     * an empty string besides its reference.
+     */
     struct Attribute {
+        Attribute(std::string aName, std::string aValue) : Name(std::move(aName)), mbShared(false) {
+            new (&mValue) std::string(std::move(aValue));
+        }
+        Attribute(std::string aName, std::shared_ptr<const std::string> apValue) :
+            Name(std::move(aName)), mbShared(true) {
+            new (&mpValue) std::shared_ptr<const std::string>(std::move(apValue));
+        }
+        Attribute(const Attribute& aOther) : Name(aOther.Name), mbShared(aOther.mbShared) {
+            if (mbShared) {
+                new (&mpValue) std::shared_ptr<const std::string>(aOther.mpValue);
+            } else {
+                new (&mValue) std::string(aOther.mValue);
+            }
+        }
+        Attribute(Attribute&& aOther) noexcept : Name(std::move(aOther.Name)), mbShared(aOther.mbShared) {
+            if (mbShared) {
+                new (&mpValue) std::shared_ptr<const std::string>(std::move(aOther.mpValue));
+            } else {
+                new (&mValue) std::string(std::move(aOther.mValue));
+            }
+        }
+        Attribute& operator=(const Attribute& aOther) {
+            if (this != &aOther) {
+                *this = Attribute(aOther);
+            }
+            return *this;
+        }
+        Attribute& operator=(Attribute&& aOther) noexcept {
+            if (this != &aOther) {
+                release();
+                Name = std::move(aOther.Name);
+                mbShared = aOther.mbShared;
+                if (mbShared) {
+                    new (&mpValue) std::shared_ptr<const std::string>(std::move(aOther.mpValue));
+                } else {
+                    new (&mValue) std::string(std::move(aOther.mValue));
+                }
+            }
+            return *this;
+        }
+        ~Attribute() {
+            release();
+        }
+
+        /// Value of the attribute, either its own or the one stored once in an intern pool
+        const std::string& value() const {
+            return mbShared ? *mpValue : mValue;
+        }
+        /// The value is a reference to a string stored once elsewhere, see share()
+        bool isShared() const {
+            return mbShared;
+        }
+        /// Own value of the attribute, to modify it (a shared value is copied first)
+        std::string& ownValue() {
+            if (mbShared) {
+                std::string value(*mpValue);
+                release();
+                new (&mValue) std::string(std::move(value));
+                mbShared = false;
+            }
+            return mValue;
+        }
+        /// Refer to a value stored once elsewhere (like in the intern pool of a Document), instead of owning it
+        void share(std::shared_ptr<const std::string> apValue) {
+            release();
+            new (&mpValue) std::shared_ptr<const std::string>(std::move(apValue));
+            mbShared = true;
+        }
+
         std::string Name;
-        std::string Value;
+
+    private:
+        void release() {
+            if (mbShared) {
+                mpValue.~shared_ptr();
+            } else {
+                mValue.~basic_string();
+            }
+        }
+
+        union {
+            std::string                         mValue;
+            std::shared_ptr<const std::string>  mpValue;
+        };
+        bool mbShared;
     };
 
+    /// Tag name, empty for a text node
+    const std::string& name() const {
+        return mName;
+    }
+    /// Text content, rendered before the children
+    const std::string& content() const {
+        return mContent;
+    }
+    const std::vector<Attribute>& attributes() const {
+        return mAttributes;
+    }
+    const std::vector<Element>& children() const {
+        return mChildren;
+    }
+    /// Self-closing Element, like \<br\> or \<img\>
+    bool isVoid() const {
+        return mFlags.isVoid();
+    }
+    /// Subtree rendered in place of this Element, or nullptr if it is not a Shared reference
+    const Element* shared() const {
+        return mFlags.shared();
+    }
+
+    /**
+     * @brief Make this Element modifiable if it is a Shared reference, by copying only the node it refers to.
+     *
+     *   The copy gets the name, content and attributes of the shared node, and a Shared reference to each
+     * of its children instead of a copy of them. Going down with child() from the root of a shared tree
+     * to a node deep inside it thus copies only the path to that node (path copying): all the rest
+     * stays shared with the original, which is never modified. Does nothing if this is not a Shared reference.
+     *
+     * @return This Element, to modify it
+     */
+    Element& unshare();
+    /// Child at the given index, made modifiable by unshare() if it is a Shared reference
+    Element& child(const size_t aIndex) {
+        Element& element = mChildren[aIndex];
+        return element.shared() ? element.unshare() : element;
+    }
+
+    /// Callbacks of a depth-first traversal of a tree, see visit()
+    class Visitor {
+    public:
+        virtual ~Visitor() = default;
+        /// Element with a tag, before its children
+        virtual void enter(const Element& aElement, const size_t aDepth) = 0;
+        /// Element with a tag, after its children
+        virtual void leave(const Element& aElement, const size_t aDepth) = 0;
+        /// Text node, without a tag
+        virtual void text(const Element& aElement, const size_t aDepth) = 0;
+    };
+
+    /**
+     * @brief Visit the tree depth-first, using an explicit stack instead of recursion.
+     *
+     *   Deeply nested trees can then be visited on threads with small stacks: the memory used
+     * is one small frame on the heap per nesting level. Shared subtrees are visited in place,
+     * and empty slots are skipped.
+     *
+     * @param[in] aVisitor  Callbacks called for each node, in document order
+     * @param[in] aMaxDepth Maximum nesting depth, the root being at depth 0
+     *
+     * @throw std::length_error if the tree is nested deeper than aMaxDepth
+     */
+    void visit(Visitor& aVisitor, const size_t aMaxDepth = HTML_MAX_DEPTH) const;
+
 protected:
     /// Constructor reserved for the Root \<html\> Element as well as the Empty
     Element();
 
-    std::ostream& toString(std::ostream& aStream, const size_t aIndentation = 0) const {
-        toStringOpen(aStream, aIndentation);
-        toStringContent(aStream, aIndentation);
-        toStringClose(aStream, aIndentation);
-        return aStream;
+    /// Kind of node, deciding how it is rendered
+    enum class Kind {
+        Placeholder,///< Empty slot, rendering nothing (see addSlots())
+        Text,       ///< Raw content text, without a tag
+        Void,       ///< Self-closing element, without content nor children
+        Leaf,       ///< Element with some content (or none) but no children, rendered on a single line
+        Container   ///< Element with children, each rendered on their own lines
+    };
+
+    Kind kind() const {
+        if (mName.empty()) {
+            return mFlags.isVoid() ? Kind::Placeholder : Kind::Text;
+        } else if (!mChildren.empty()) {
+            return Kind::Container;
+        } else if (mFlags.isVoid() && mContent.empty()) {
+            return Kind::Void;
+        }
+        return Kind::Leaf;
     }
 
 private:
-    void toStringOpen(std::ostream& aStream, const size_t aIndentation) const {
-        if (!mName.empty()) {
-            std::fill_n(std::ostream_iterator<char>(aStream), aIndentation, ' ');
-            aStream << '<' << mName;
-
-            for (const auto& attr : mAttributes) {
-                aStream << ' ' << attr.Name;
-                if (!attr.Value.empty()) {
-                    aStream << "=\"" << attr.Value << "\"";
-                }
-            }
+    /// Callbacks rendering the HTML of the visited nodes, called directly instead of through a Visitor
+    class Renderer;
 
-            if (mContent.empty()) {
-                // Note: using children for content is less efficient/breaking the assumption
-                if (!mChildren.empty() || mbVoid) {
-                    aStream << ">" HTML_ENDLINE;
-                } else {
-                    aStream << ">";
-                }
-            } else {
-                aStream << '>';
-            }
+    /// Depth-first traversal behind visit() and render(), calling the enter(), leave() and text() of aCallbacks
+    template<typename Callbacks>
+    void walk(Callbacks& aCallbacks, const size_t aMaxDepth) const;
+
+    /// Destroy the children level by level, so that each destructor called has no children left
+    void releaseChildren();
+
+    /// Buffer receiving the text given to append(): the content, the last Text child or a new one
+    std::string& textBuffer() {
+        if (mChildren.empty()) {
+            return mContent;
         }
-    }
-    void toStringContent(std::ostream& aStream, const size_t aIndentation) const {
-        if (!mName.empty()) {
-            aStream << mContent;
-            for (auto& child : mChildren) {
-                child.toString(aStream, aIndentation + HTML_INDENTATION);
-            }
-        } else {
-            std::fill_n(std::ostream_iterator<char>(aStream), aIndentation, ' ');
-            aStream << mContent << HTML_ENDLINE;
+        const Element& last = mChildren.back();
+        if (!last.mName.empty() || last.isVoid() || last.shared()) {
+            addChild(Element(""));
         }
+        return mChildren.back().mContent;
+    }
+
+    /**
+     * @brief Recycling of the buffers of the Elements, implemented by NodePool (in NodePool.h).
+     *
+     *   Called through this interface, so that only the code using a NodePool compiles its implementation.
+     */
+    class Recycler {
+    public:
+        virtual ~Recycler() = default;
+        /// Take the buffers of an Element being destroyed, its children already released
+        virtual void recycle(Element& aElement) = 0;
+        /// Move the items to a recycled buffer with room for aCapacity items, and take the previous buffer
+        virtual void grow(std::vector<Element>& aChildren, const size_t aCapacity) = 0;
+        virtual void grow(std::vector<Attribute>& aAttributes, const size_t aCapacity) = 0;
+        /// Copy of a text, in a recycled string if it does not fit in the string itself
+        virtual std::string copy(const char* apText, const size_t aSize) = 0;
+    };
+    /// Recycler in scope on the current thread (see NodePool), or nullptr
+    static Recycler*& recycler() {
+        thread_local Recycler* spRecycler = nullptr;
+        return spRecycler;
+    }
+    /// Give the buffers of the Element to the NodePool in scope, once its children are released
+    void recycle();
+    /// Make room for one more item, growing a full vector into a buffer recycled by the NodePool in scope if any
+    static void makeRoom(std::vector<Element>& aChildren);
+    static void makeRoom(std::vector<Attribute>& aAttributes);
+    /// Copy of a text, in a string recycled by the NodePool in scope if any
+    static std::string newString(const char* apText, const size_t aSize);
+    static std::string newString(const char* apText) {
+        return newString(apText, std::char_traits<char>::length(apText));
+    }
+
+protected:
+    /// Append a child, see operator<<(); subclasses restricting their children use it in their own operator<<()
+    void addChild(Element&& aElement) {
+        makeRoom(mChildren);
+        mChildren.push_back(std::move(aElement));
     }
-    void toStringClose(std::ostream& aStream, const size_t aIndentation) const {
-        if (!mName.empty()) {
-            if (!mChildren.empty()) {
-                std::fill_n(std::ostream_iterator<char>(aStream), aIndentation, ' ');
+
+    /**
+     * @brief Self-closing flag and reference to a Shared subtree, packed in a single word to keep every node small.
+     *
+     *   Only the few Shared nodes allocate the std::shared_ptr to their subtree, the alignment of which leaves
+     * the lowest bit of its address free for the flag.
+     */
+    class Flags {
+    public:
+        Flags() = default;
+        Flags(const Flags& aOther) : mBits(aOther.mBits & VOID_BIT) {
+            if (aOther.pointer()) {
+                share(*aOther.pointer());
             }
-            // Note: using children for content is less efficient/breaking the assumption
-            if (!mContent.empty() || !mChildren.empty() || !mbVoid) {
-                aStream << "</" << mName << ">" HTML_ENDLINE;
+        }
+        Flags(Flags&& aOther) noexcept : mBits(aOther.mBits) {
+            aOther.mBits = 0;
+        }
+        Flags& operator=(const Flags& aOther) {
+            Flags copy(aOther);
+            std::swap(mBits, copy.mBits);
+            return *this;
+        }
+        Flags& operator=(Flags&& aOther) noexcept {
+            std::swap(mBits, aOther.mBits);
+            return *this;
+        }
+        ~Flags() {
+            delete pointer();
+        }
+
+        bool isVoid() const {
+            return 0 != (mBits & VOID_BIT);
+        }
+        void setVoid(const bool abVoid) {
+            mBits = abVoid ? (mBits | VOID_BIT) : (mBits & ~VOID_BIT);
+        }
+        const Element* shared() const {
+            return pointer() ? pointer()->get() : nullptr;
+        }
+        std::shared_ptr<const Element> reference() const {
+            return pointer() ? *pointer() : nullptr;
+        }
+        void share(std::shared_ptr<const Element> apElement) {
+            if (pointer()) {
+                *pointer() = std::move(apElement);
+            } else if (apElement) {
+                mBits |= reinterpret_cast<std::uintptr_t>(new std::shared_ptr<const Element>(std::move(apElement)));
             }
         }
-    }
 
-protected:
+    private:
+        static const std::uintptr_t VOID_BIT = 1u;
+
+        std::shared_ptr<const Element>* pointer() const {
+            return reinterpret_cast<std::shared_ptr<const Element>*>(mBits & ~VOID_BIT);
+        }
+
+        std::uintptr_t mBits = 0;
+    };
+
     std::string mName;
     std::string mContent;
     std::vector<Attribute> mAttributes;
@@ -177,24 +557,50 @@ protected:
     // Self-closing elements complete list:
     // <br> <hr> <img> <input> <link> <meta> <col>
     // <area> <base> <command> <embed> <keygen> <param> <source> <track> <wbr>
-    bool mbVoid = false;
+    // and immutable subtree rendered in place of this Element (see Shared)
+    Flags mFlags;
 };
 
-inline std::ostream& operator<<(std::ostream& aStream, const Element& aElement) {
-    return aElement.toString(aStream);
+HTML_INLINE std::ostream& operator<<(std::ostream& aStream, const Element& aElement);
+
+/// Make an immutable subtree that can be shared between several Documents, see Shared
+inline std::shared_ptr<const Element> share(Element&& aElement) {
+    return std::make_shared<const Element>(std::move(aElement));
 }
 
+/**
+ * @brief Reference to an immutable subtree shared between several Documents, rendered in place without any copy.
+ *
+ *   Build the common parts of a page (navigation bar, footer...) only once with share(),
+ * then insert them in each variant of the page: only the reference count is copied.
+ * Reference counts are atomic, so a shared subtree can be used by Documents built and rendered on other threads.
+ * A shared subtree itself is never modified: to change a variant, Element::unshare() and Element::child()
+ * copy only the nodes on the path to the change, see also Document(const std::shared_ptr<const Element>&).
+ */
+class Shared : public Element {
+public:
+    explicit Shared(std::shared_ptr<const Element> apElement) : Element("") {
+        mFlags.share(std::move(apElement));
+    }
+};
+
 /// Empty Element, useful as a default parameter for instance
 class Empty : public Element {
 public:
     Empty() : Element() {}
 };
 
-/// Raw content text (unnamed Element) to use as text values between child Elements
+/**
+ * @brief Raw content text (unnamed Element) to use as text values between child Elements.
+ *
+ *   A text node is a full Element stored by value among the children of its parent, with an empty name:
+ * it has the same size as any other node, though its empty vectors of attributes and children never allocate.
+ * For text-heavy content, Element::append() concatenates consecutive pieces into a single node instead.
+ */
 class Text : public Element {
 public:
     explicit Text(const char* apContent) : Element("", apContent) {}
-    explicit Text(std::string&& aContent) : Element("", aContent) {}
+    explicit Text(std::string&& aContent) : Element("", std::move(aContent)) {}
     explicit Text(const std::string& aContent) : Element("", aContent) {}
 };
 
@@ -210,6 +616,96 @@ inline Element&& Element::operator<<(const std::string& aContent) {
     return *this << Text(aContent);
 }
 
+/**
+ * @brief Element with chained setters returning its own type.
+ *
+ *   The setters of Element return an Element&&, which is not accepted by the operator<< of the parents
+ * restricting their children (like Select, which only accepts Option): they are redefined here to return
+ * the Derived type, so that Select("s") << Option("v").id("x") compiles.
+ */
+template<typename Derived>
+class Chained : public Element {
+public:
+    Derived&& addAttribute(const char* apName, const char* apValue) {
+        Element::addAttribute(apName, apValue);
+        return self();
+    }
+    Derived&& addAttribute(const char* apName, const std::string& aValue) {
+        Element::addAttribute(apName, aValue);
+        return self();
+    }
+    Derived&& addAttribute(const char* apName, const unsigned int aValue) {
+        Element::addAttribute(apName, aValue);
+        return self();
+    }
+
+    Derived&& id(const char* apValue) {
+        return addAttribute("id", apValue);
+    }
+    Derived&& id(const std::string& aValue) {
+        return addAttribute("id", aValue);
+    }
+
+    Derived&& cls(const char* apValue) {
+        return addAttribute("class", apValue);
+    }
+    Derived&& cls(const std::string& aValue) {
+        return addAttribute("class", aValue);
+    }
+
+    Derived&& title(const char* apValue) {
+        return addAttribute("title", apValue);
+    }
+    Derived&& title(const std::string& aValue) {
+        return addAttribute("title", aValue);
+    }
+
+    Derived&& style(const char* apValue) {
+        return addAttribute("style", apValue);
+    }
+    Derived&& style(const std::string& aValue) {
+        return addAttribute("style", aValue);
+    }
+
+    Derived&& reserve(const size_t aNbChildren) {
+        Element::reserve(aNbChildren);
+        return self();
+    }
+
+protected:
+    explicit Chained(const char* apName, const char* apContent = nullptr) : Element(apName, apContent) {}
+    Chained(const char* apName, std::string&& aContent) : Element(apName, std::move(aContent)) {}
+    Chained(const char* apName, const std::string& aContent) : Element(apName, aContent) {}
+
+    Derived&& self() {
+        return std::move(*static_cast<Derived*>(this));
+    }
+};
+
+/**
+ * @brief Element restricting the types of its children, with chained setters returning its own type.
+ *
+ *   The setters of Element return an Element&&, on which operator<< accepts any child again:
+ * Chained redefines them to return the derived type, so that Table().cls("table") << Div() does not compile.
+ */
+template<typename Derived>
+class Restricted : public Chained<Derived> {
+public:
+    /// Child slot at the given index, accepting only the children allowed by the Derived Element
+    Element::Slot<Derived> slot(const size_t aIndex) {
+        return Element::Slot<Derived>(this->mChildren[aIndex]);
+    }
+
+    // Text is not allowed directly in these Elements, only the children they accept
+    Derived&& append(const char* apText, const size_t aSize) = delete;
+    Derived&& append(const char* apText) = delete;
+    Derived&& append(const std::string& aText) = delete;
+    Derived&& reserveText(const size_t aSize) = delete;
+
+protected:
+    explicit Restricted(const char* apName) : Chained<Derived>(apName) {}
+};
+
 /// \<title\> Element required in \<head\>
 class Title : public Element {
 public:
@@ -242,6 +738,16 @@ public:
         addAttribute("integrity", aValue);
         return std::move(*this);
     }
+    /// Integrity computed from the local copy of the script, cached until the file changes (include Asset.h to use it);
+    /// not set if the file cannot be read
+    template<typename Cache = Asset>
+    Script&& integrityFromFile(const std::string& aPath, const Digest aDigest = Digest::Sha384) {
+        const std::shared_ptr<const std::string> pIntegrity = Cache::integrity(aPath, aDigest);
+        if (!pIntegrity->empty()) {
+            addAttribute("integrity", *pIntegrity);
+        }
+        return std::move(*this);
+    }
     Script&& crossorigin(const std::string& aValue) {
         addAttribute("crossorigin", aValue);
         return std::move(*this);
@@ -254,12 +760,12 @@ public:
     Meta() : Element("meta") {}
     explicit Meta(const char* apCharset) : Element("meta") {
         addAttribute("charset", apCharset);
-        mbVoid = true;
+        mFlags.setVoid(true);
     }
     explicit Meta(const char* apName, const char* apContent) : Element("meta") {
         addAttribute("name", apName);
         addAttribute("content", apContent);
-        mbVoid = true;
+        mFlags.setVoid(true);
     }
 };
 
@@ -272,13 +778,23 @@ public:
         if (apType) {
             addAttribute("type", apType);
         }
-        mbVoid = true;
+        mFlags.setVoid(true);
     }
 
     Rel&& integrity(const std::string& aValue) {
         addAttribute("integrity", aValue);
         return std::move(*this);
     }
+    /// Integrity computed from the local copy of the resource, cached until the file changes
+    /// (include Asset.h to use it); not set if the file cannot be read
+    template<typename Cache = Asset>
+    Rel&& integrityFromFile(const std::string& aPath, const Digest aDigest = Digest::Sha384) {
+        const std::shared_ptr<const std::string> pIntegrity = Cache::integrity(aPath, aDigest);
+        if (!pIntegrity->empty()) {
+            addAttribute("integrity", *pIntegrity);
+        }
+        return std::move(*this);
+    }
     Rel&& crossorigin(const std::string& aValue) {
         addAttribute("crossorigin", aValue);
         return std::move(*this);
@@ -297,33 +813,33 @@ public:
 };
 
 /// \<head\> required as the first child Element in every HTML Document
-class Head : public Element {
+class Head : public Restricted<Head> {
 public:
-    Head() : Element("head") {}
+    Head() : Restricted("head") {}
 
     Head&& operator<<(Element&& aElement) = delete;
     Head&& operator<<(Title&& aTitle) {
-        mChildren.push_back(std::move(aTitle));
+        addChild(std::move(aTitle));
         return std::move(*this);
     }
     Head&& operator<<(Style&& aStyle) {
-        mChildren.push_back(std::move(aStyle));
+        addChild(std::move(aStyle));
         return std::move(*this);
     }
     Head&& operator<<(Script&& aScript) {
-        mChildren.push_back(std::move(aScript));
+        addChild(std::move(aScript));
         return std::move(*this);
     }
     Head&& operator<<(Meta&& aMeta) {
-        mChildren.push_back(std::move(aMeta));
+        addChild(std::move(aMeta));
         return std::move(*this);
     }
     Head&& operator<<(Rel&& aRel) {
-        mChildren.push_back(std::move(aRel));
+        addChild(std::move(aRel));
         return std::move(*this);
     }
     Head&& operator<<(Base&& aBase) {
-        mChildren.push_back(std::move(aBase));
+        addChild(std::move(aBase));
         return std::move(*this);
     }
 };
@@ -335,7 +851,11 @@ public:
 };
 
 // Constructor of the Root \<html\> Element
-inline Element::Element() : mName("html"), mChildren{Head(), Body()} {
+inline Element::Element() : mName("html") {
+    // Moved in, instead of copied from an initializer list
+    reserve(2);
+    addChild(Head());
+    addChild(Body());
 }
 
 
@@ -343,19 +863,19 @@ inline Element::Element() : mName("html"), mChildren{Head(), Body()} {
 class Break : public Element {
 public:
     Break() : Element("br") {
-        mbVoid = true;
+        mFlags.setVoid(true);
     }
 };
 
 /// \<th\> Table Header Column Element
-class ColHeader : public Element {
+class ColHeader : public Chained<ColHeader> {
 public:
-    explicit ColHeader(const char* apContent = nullptr) : Element("th", apContent) {}
-    explicit ColHeader(std::string&& aContent) : Element("th", aContent) {}
-    explicit ColHeader(const std::string& aContent) : Element("th", aContent) {}
+    explicit ColHeader(const char* apContent = nullptr) : Chained("th", apContent) {}
+    explicit ColHeader(std::string&& aContent) : Chained("th", std::move(aContent)) {}
+    explicit ColHeader(const std::string& aContent) : Chained("th", aContent) {}
 
     ColHeader&& operator<<(Element&& aElement) {
-        mChildren.push_back(std::move(aElement));
+        addChild(std::move(aElement));
         return std::move(*this);
     }
 
@@ -374,21 +894,21 @@ public:
 };
 
 /// \<td\> Table Column Element
-class Col : public Element {
-public:
-    explicit Col(const char* apContent = nullptr) : Element("td", apContent) {}
-    explicit Col(std::string&& aContent) : Element("td", aContent) {}
-    explicit Col(const std::string& aContent) : Element("td", aContent) {}
-    explicit Col(const bool abContent) : Element("td", to_string(abContent)) {}
-    explicit Col(const int aContent) : Element("td", std::to_string(aContent)) {}
-    explicit Col(const unsigned int aContent) : Element("td", std::to_string(aContent)) {}
-    explicit Col(const long long aContent) : Element("td", std::to_string(aContent)) {}
-    explicit Col(const unsigned long long aContent) : Element("td", std::to_string(aContent)) {}
-    explicit Col(const float aContent) : Element("td", std::to_string(aContent)) {}
-    explicit Col(const double aContent) : Element("td", std::to_string(aContent)) {}
+class Col : public Chained<Col> {
+public:
+    explicit Col(const char* apContent = nullptr) : Chained("td", apContent) {}
+    explicit Col(std::string&& aContent) : Chained("td", std::move(aContent)) {}
+    explicit Col(const std::string& aContent) : Chained("td", aContent) {}
+    explicit Col(const bool abContent) : Chained("td", to_string(abContent)) {}
+    explicit Col(const int aContent) : Chained("td", std::to_string(aContent)) {}
+    explicit Col(const unsigned int aContent) : Chained("td", std::to_string(aContent)) {}
+    explicit Col(const long long aContent) : Chained("td", std::to_string(aContent)) {}
+    explicit Col(const unsigned long long aContent) : Chained("td", std::to_string(aContent)) {}
+    explicit Col(const float aContent) : Chained("td", std::to_string(aContent)) {}
+    explicit Col(const double aContent) : Chained("td", std::to_string(aContent)) {}
 
     Col&& operator<<(Element&& aElement) {
-        mChildren.push_back(std::move(aElement));
+        addChild(std::move(aElement));
         return std::move(*this);
     }
 
@@ -404,28 +924,20 @@ public:
         }
         return std::move(*this);
     }
-    Col&& style(const std::string& aValue) {
-        Element::style(aValue);
-        return std::move(*this);
-    }
 };
 
 /// \<tr\> Table Row Element
-class Row : public Element {
+class Row : public Restricted<Row> {
 public:
-    Row() : Element("tr") {}
+    Row() : Restricted("tr") {}
 
     Row&& operator<<(Element&& aElement) = delete;
     Row&& operator<<(ColHeader&& aCol) {
-        mChildren.push_back(std::move(aCol));
+        addChild(std::move(aCol));
         return std::move(*this);
     }
     Row&& operator<<(Col&& aCol) {
-        mChildren.push_back(std::move(aCol));
-        return std::move(*this);
-    }
-    Row&& style(const std::string& aValue) {
-        Element::style(aValue);
+        addChild(std::move(aCol));
         return std::move(*this);
     }
 };
@@ -437,50 +949,45 @@ public:
 };
 
 /// \<table\> Element
-class Table : public Element {
+class Table : public Restricted<Table> {
 public:
-    Table() : Element("table") {}
+    Table() : Restricted("table") {}
 
     Table&& operator<<(Element&& aElement) = delete;
     Table&& operator<<(Row&& aRow) {
-        mChildren.push_back(std::move(aRow));
+        addChild(std::move(aRow));
         return std::move(*this);
     }
     Table&& operator<<(Caption&& aCaption) {
-        mChildren.push_back(std::move(aCaption));
+        addChild(std::move(aCaption));
         return std::move(*this);
     }
 };
 
 /// \<li\> List Item Element to put in List
-class ListItem : public Element {
+class ListItem : public Chained<ListItem> {
 public:
-    ListItem() : Element("li") {}
-    explicit ListItem(const char* apContent) : Element("li", apContent) {}
-    explicit ListItem(const std::string& aContent) : Element("li", aContent) {}
+    ListItem() : Chained("li") {}
+    explicit ListItem(const char* apContent) : Chained("li", apContent) {}
+    explicit ListItem(const std::string& aContent) : Chained("li", aContent) {}
 
     ListItem&& operator<<(Element&& aElement) {
-        mChildren.push_back(std::move(aElement));
-        return std::move(*this);
-    }
-
-    ListItem&& cls(const std::string& aValue) {
-        addAttribute("class", aValue);
+        addChild(std::move(aElement));
         return std::move(*this);
     }
 };
 
 /// \<ol\> Ordered List or \<ul\> Unordered List Element to use with ListItem
-class List : public Element {
+class List : public Restricted<List> {
 public:
-    explicit List(const bool abOrdered = false) : Element(abOrdered?"ol":"ul") {}
-    List(const bool abOrdered, const char* apClass) : Element(abOrdered ?"ol":"ul") {
+    explicit List(const bool abOrdered = false) : Restricted(abOrdered?"ol":"ul") {}
+    List(const bool abOrdered, const char* apClass) : Restricted(abOrdered ?"ol":"ul") {
         cls(apClass);
     }
 
     List&& operator<<(Element&& aElement) = delete;
     List&& operator<<(ListItem&& aItem) {
-        mChildren.push_back(std::move(aItem));
+        addChild(std::move(aItem));
         return std::move(*this);
     }
 };
@@ -512,7 +1019,7 @@ public:
         if (apValue) {
             addAttribute("value", apValue);
         }
-        mbVoid = true;
+        mFlags.setVoid(true);
     }
 
     Input&& addAttribute(const char* apName, const std::string& aValue) {
@@ -713,33 +1220,57 @@ public:
     }
 };
 
+/// \<option\> Element for Select and DataList
+class Option : public Chained<Option> {
+public:
+    explicit Option(const char* apValue, const char* apContent = nullptr) : Chained("option", apContent) {
+        addAttribute("value", apValue);
+    }
+
+    Option&& selected(const bool abSelected = true) {
+        if (abSelected) {
+            addAttribute("selected", "");
+        }
+        return std::move(*this);
+    }
+};
+
 /// \<datalist\> Element for InputList, to use with Option Elements
-class DataList : public Element {
+class DataList : public Restricted<DataList> {
 public:
-    explicit DataList(const char* apId) : Element("datalist") {
+    explicit DataList(const char* apId) : Restricted("datalist") {
         addAttribute("id", apId);
     }
+
+    DataList&& operator<<(Element&& aElement) = delete;
+    DataList&& operator<<(Option&& aOption) {
+        addChild(std::move(aOption));
+        return std::move(*this);
+    }
+    /// Block of options, see Options (in Options.h)
+    template<typename Block, typename = typename std::enable_if<std::is_same<Block, Options>::value>::type>
+    DataList&& operator<<(Block&& aOptions) {
+        addChild(std::move(aOptions));
+        return std::move(*this);
+    }
 };
 
 /// \<select\> Element to use with Option Elements
-class Select : public Element {
+class Select : public Restricted<Select> {
 public:
-    explicit Select(const char* apName) : Element("select") {
+    explicit Select(const char* apName) : Restricted("select") {
         addAttribute("name", apName);
     }
-};
 
-/// \<option\> Element for Select and DataList
-class Option : public Element {
-public:
-    explicit Option(const char* apValue, const char* apContent = nullptr) : Element("option", apContent) {
-        addAttribute("value", apValue);
+    Select&& operator<<(Element&& aElement) = delete;
+    Select&& operator<<(Option&& aOption) {
+        addChild(std::move(aOption));
+        return std::move(*this);
     }
-
-    Option&& selected(const bool abSelected = true) {
-        if (abSelected) {
-            addAttribute("selected", "");
-        }
+    /// Block of options, see Options (in Options.h)
+    template<typename Block, typename = typename std::enable_if<std::is_same<Block, Options>::value>::type>
+    Select&& operator<<(Block&& aOptions) {
+        addChild(std::move(aOptions));
         return std::move(*this);
     }
 };
@@ -779,7 +1310,7 @@ class Small : public Element {
 public:
     Small() : Element("small") {}
     explicit Small(const char* apContent) : Element("small", apContent) {}
-    explicit Small(std::string&& aContent) : Element("small", aContent) {}
+    explicit Small(std::string&& aContent) : Element("small", std::move(aContent)) {}
     explicit Small(const std::string& aContent) : Element("small", aContent) {}
 };
 
@@ -788,7 +1319,7 @@ class Strong : public Element {
 public:
     Strong() : Element("strong") {}
     explicit Strong(const char* apContent) : Element("strong", apContent) {}
-    explicit Strong(std::string&& aContent) : Element("strong", aContent) {}
+    explicit Strong(std::string&& aContent) : Element("strong", std::move(aContent)) {}
     explicit Strong(const std::string& aContent) : Element("strong", aContent) {}
 };
 
@@ -858,7 +1389,7 @@ public:
         if (0 < aHeight) {
             addAttribute("height", aHeight);
         }
-        mbVoid = true;
+        mFlags.setVoid(true);
     }
 };
 
@@ -987,3 +1518,7 @@ public:
 
 
 } // namespace HTML
+
+#ifndef HTML_COMPILED_LIBRARY
+#include "Element.inl"
+#endif
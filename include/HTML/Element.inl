@@ -0,0 +1,283 @@
+/**
+ * @file    Element.inl
+ * @ingroup HtmlBuilder
+ * @brief   Serialization of an Element in the HTML Document Object Model.
+ *
+ *   Included by Element.h in header-only mode, or compiled once in the HtmlBuilder library
+ * when HTML_COMPILED_LIBRARY is defined.
+ *
+ * Copyright (c) 2017-2021 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+ *
+ * Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+ * or copy at http://opensource.org/licenses/MIT)
+ */
+#pragma once
+
+#include "Element.h"
+#include "RenderContext.h"
+
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+/// A simple C++ HTML Generator library.
+namespace HTML {
+
+HTML_INLINE Element::Element(const Element& aOther) :
+    mName(aOther.mName), mContent(aOther.mContent), mAttributes(aOther.mAttributes),
+    mFlags(aOther.mFlags) {
+    // Path from the original to the node being copied, each with the index of the next child to copy, like walk(),
+    // and path of the corresponding copies, the children of which are reserved so that they do not move
+    std::vector<std::pair<const Element*, size_t>> originals;
+    std::vector<Element*> copies;
+    if (!aOther.mChildren.empty()) {
+        mChildren.reserve(aOther.mChildren.size());
+        originals.push_back(std::make_pair(&aOther, 0));
+        copies.push_back(this);
+    }
+    while (!originals.empty()) {
+        auto& top = originals.back();
+        if (top.second == top.first->mChildren.size()) {
+            originals.pop_back();
+            copies.pop_back();
+            continue;
+        }
+        const Element& child = top.first->mChildren[top.second++];
+        copies.back()->mChildren.push_back(Element(child.mName.c_str(), child.mContent));
+        Element& last = copies.back()->mChildren.back();
+        last.mAttributes = child.mAttributes;
+        last.mFlags = child.mFlags;
+        if (!child.mChildren.empty()) {
+            last.mChildren.reserve(child.mChildren.size());
+            originals.push_back(std::make_pair(&child, 0));
+            copies.push_back(&last);
+        }
+    }
+}
+
+HTML_INLINE void Element::releaseChildren() {
+    std::vector<Element> pending(std::move(mChildren));
+    while (!pending.empty()) {
+        Element last(std::move(pending.back()));
+        pending.pop_back();
+        for (auto& child : last.mChildren) {
+            makeRoom(pending);
+            pending.push_back(std::move(child));
+        }
+        last.mChildren.clear();
+    }
+    mChildren = std::move(pending);  // empty, but its buffer can be recycled
+}
+
+HTML_INLINE void Element::recycle() {
+    recycler()->recycle(*this);
+}
+
+HTML_INLINE void Element::makeRoom(std::vector<Element>& aChildren) {
+    if ((aChildren.size() == aChildren.capacity()) && (nullptr != recycler())) {
+        recycler()->grow(aChildren, aChildren.empty() ? 1 : 2 * aChildren.size());
+    }
+}
+
+HTML_INLINE void Element::makeRoom(std::vector<Attribute>& aAttributes) {
+    if ((aAttributes.size() == aAttributes.capacity()) && (nullptr != recycler())) {
+        recycler()->grow(aAttributes, aAttributes.empty() ? 1 : 2 * aAttributes.size());
+    }
+}
+
+HTML_INLINE std::string Element::newString(const char* apText, const size_t aSize) {
+    return (nullptr != recycler()) ? recycler()->copy(apText, aSize) : std::string(apText, aSize);
+}
+
+HTML_INLINE Element& Element::unshare() {
+    if (nullptr == mFlags.shared()) {
+        return *this;
+    }
+    std::shared_ptr<const Element> pNode = mFlags.reference();
+    while (nullptr != pNode->shared()) {
+        pNode = pNode->mFlags.reference();
+    }
+    // Built member by member, so that unshare() does not need the deep copy of a tree
+    Element copy(pNode->mName.c_str(), pNode->mContent);
+    copy.mAttributes.reserve(pNode->mAttributes.size());
+    for (const Attribute& attribute : pNode->mAttributes) {
+        copy.mAttributes.push_back(attribute);
+    }
+    copy.mFlags.setVoid(pNode->isVoid());
+    copy.reserve(pNode->mChildren.size());
+    for (const Element& child : pNode->mChildren) {
+        if (Kind::Placeholder == child.kind()) {
+            Element placeholder("");
+            placeholder.mFlags.setVoid(true);
+            copy.addChild(std::move(placeholder));
+        } else if (nullptr != child.shared()) {
+            copy.addChild(Shared(child.mFlags.reference()));
+        } else {
+            // Aliasing constructor: the reference to the child keeps the whole shared tree alive
+            copy.addChild(Shared(std::shared_ptr<const Element>(pNode, &child)));
+        }
+    }
+    *this = std::move(copy);
+    return *this;
+}
+
+HTML_INLINE std::ostream& operator<<(std::ostream& aStream, const Element& aElement) {
+    RenderContext& context = RenderContext::local();
+    context.Buffer.clear();
+    aElement.render(context.Buffer, context);
+    return aStream.write(context.Buffer.data(), static_cast<std::streamsize>(context.Buffer.size()));
+}
+
+HTML_INLINE std::string Element::toString() const {
+    std::string output;
+    render(output, RenderContext::local());
+    return output;
+}
+
+class Element::Renderer {
+public:
+    Renderer(std::string& aOutput, RenderContext& aContext) : mOutput(aOutput), mContext(aContext) {}
+
+    void enter(const Element& aElement, const size_t aDepth) {
+        ++mContext.NbNodes;
+        const size_t indentation = aDepth * mContext.Indentation;
+        const RenderContext::Syntax syntax = (aDepth > mRawDepth) ? mRawSyntax : mContext.syntax(aElement.mName);
+        switch (aElement.kind()) {
+        case Kind::Void:
+        case Kind::Leaf:
+            renderLeaf(aElement, indentation, syntax);
+            break;
+        case Kind::Container:
+            appendOpen(aElement, indentation);
+            mOutput += '>';
+            // Note: using children for content is less efficient/breaking the assumption
+            if (aElement.mContent.empty()) {
+                mOutput += mContext.Endline;
+            } else {
+                mContext.append(mOutput, aElement.mContent, syntax);
+            }
+            if ((aDepth < mRawDepth) && (RenderContext::Syntax::Html != syntax)) {
+                // The whole subtree of a <script> or a <style> is its raw text
+                mRawDepth = aDepth;
+                mRawSyntax = syntax;
+            }
+            break;
+        case Kind::Placeholder:
+        case Kind::Text:
+        default:
+            break;
+        }
+    }
+
+    void leave(const Element& aElement, const size_t aDepth) {
+        if (aDepth == mRawDepth) {
+            mRawDepth = NONE;
+            mRawSyntax = RenderContext::Syntax::Html;
+        }
+        if (aElement.kind() == Kind::Container) {
+            mOutput.append(aDepth * mContext.Indentation, ' ');
+            mOutput += "</";
+            mOutput += aElement.mName;
+            mOutput += '>';
+            mOutput += mContext.Endline;
+        }
+    }
+
+    void text(const Element& aElement, const size_t aDepth) {
+        ++mContext.NbNodes;
+        mOutput.append(aDepth * mContext.Indentation, ' ');
+        mContext.append(mOutput, aElement.mContent, (aDepth > mRawDepth) ? mRawSyntax : RenderContext::Syntax::Html);
+        mOutput += mContext.Endline;
+    }
+
+private:
+    void renderLeaf(const Element& aElement, const size_t aIndentation, const RenderContext::Syntax aSyntax) {
+        // The whole Element fits on one line
+        appendOpen(aElement, aIndentation);
+        mOutput += '>';
+        if (!aElement.mFlags.isVoid() || !aElement.mContent.empty()) {
+            mContext.append(mOutput, aElement.mContent, aSyntax);
+            mOutput += "</";
+            mOutput += aElement.mName;
+            mOutput += '>';
+        }
+        mOutput += mContext.Endline;
+    }
+
+    /// Append the indentation, the opening tag and the attributes, without the closing '>'
+    void appendOpen(const Element& aElement, const size_t aIndentation) {
+        mOutput.append(aIndentation, ' ');
+        mOutput += '<';
+        mOutput += aElement.mName;
+        for (const auto& attr : aElement.mAttributes) {
+            mOutput += ' ';
+            mOutput += attr.Name;
+            const std::string& value = attr.value();
+            if (!value.empty()) {
+                mOutput += "=\"";
+                mContext.append(mOutput, value);
+                mOutput += '"';
+            }
+        }
+    }
+
+
+    static const size_t NONE = static_cast<size_t>(-1);
+
+    std::string&            mOutput;
+    RenderContext&          mContext;
+    size_t                  mRawDepth = NONE;   ///< Depth of the \<script\> or \<style\> being rendered, if any
+    RenderContext::Syntax   mRawSyntax = RenderContext::Syntax::Html;   ///< Syntax of its raw text
+};
+
+HTML_INLINE void Element::render(std::string& aOutput, RenderContext& aContext) const {
+    const size_t size = aOutput.size();
+    Renderer renderer(aOutput, aContext);
+    walk(renderer, aContext.MaxDepth);
+    aContext.NbBytes += aOutput.size() - size;
+}
+
+HTML_INLINE void Element::visit(Visitor& aVisitor, const size_t aMaxDepth) const {
+    walk(aVisitor, aMaxDepth);
+}
+
+template<typename Callbacks>
+void Element::walk(Callbacks& aVisitor, const size_t aMaxDepth) const {
+    // Path from the root to the current node, each with the index of the next child to visit
+    std::vector<std::pair<const Element*, size_t>> stack;
+    const Element* pElement = this;
+    while (pElement) {
+        while (pElement->shared()) {
+            pElement = pElement->shared();
+        }
+        const size_t depth = stack.size();
+        if (depth > aMaxDepth) {
+            throw std::length_error("HTML: tree nested deeper than the maximum depth");
+        }
+        if (!pElement->mName.empty()) {
+            aVisitor.enter(*pElement, depth);
+            if (pElement->mChildren.empty()) {
+                aVisitor.leave(*pElement, depth);
+            } else {
+                stack.push_back(std::make_pair(pElement, 0));
+            }
+        } else if (!pElement->isVoid()) {
+            aVisitor.text(*pElement, depth);
+        }
+        // Next node: the next child of the nearest ancestor not completely visited
+        pElement = nullptr;
+        while (!pElement && !stack.empty()) {
+            auto& top = stack.back();
+            if (top.second < top.first->mChildren.size()) {
+                pElement = &top.first->mChildren[top.second++];
+            } else {
+                aVisitor.leave(*top.first, stack.size() - 1);
+                stack.pop_back();
+            }
+        }
+    }
+}
+
+} // namespace HTML
@@ -0,0 +1,238 @@
+/**
+ * @file    FormSchema.h
+ * @ingroup HtmlBuilder
+ * @brief   Form fields generated from the description of a C++ struct, with the static markup built once per type.
+ *
+ * Copyright (c) 2017-2021 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+ *
+ * Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+ * or copy at http://opensource.org/licenses/MIT)
+ */
+#pragma once
+
+#include "Element.h"
+#include "RenderContext.h"
+
+#include <functional>
+#include <initializer_list>
+#include <string>
+#include <utility>
+#include <vector>
+
+/// A simple C++ HTML Generator library.
+namespace HTML {
+
+/**
+ * @brief Description of the form fields of a struct, to specialize for each struct rendered with FormOf.
+ *
+ * @verbatim
+struct User { std::string name; unsigned int age; bool admin; std::string role; };
+
+namespace HTML {
+template<> struct FormSchema<User> {
+    static void describe(FormFields<User>& aFields) {
+        aFields.fieldClass("form-group")
+               .input("text", "name", "Name", &User::name)
+               .number("age", "Age", &User::age)
+               .checkbox("admin", "Administrator", &User::admin)
+               .select("role", "Role", &User::role, {{"user", "User"}, {"admin", "Admin"}});
+    }
+};
+} @endverbatim
+ */
+template<typename T>
+struct FormSchema;
+
+/**
+ * @brief Fields of the form of a struct, compiled once into static markup and slots for the values.
+ *
+ *   The fields are built as Elements only once per type, with a marker where each value or flag goes,
+ * and rendered into static markup split at the markers. Filling the form with a struct then only appends
+ * the static markup and the escaped values, without building any Element.
+ */
+template<typename T>
+class FormFields {
+public:
+    /// Class of the \<div\> wrapping each label and its input
+    FormFields& fieldClass(const char* apClass) {
+        mFieldClass = apClass;
+        return *this;
+    }
+
+    /// \<input\> of the given type ("text", "email", "date"...) for a string member
+    FormFields& input(const char* apType, const char* apName, const char* apLabel, std::string T::* apMember) {
+        add(apName, apLabel, Input(apType, apName), [apMember](const T& aValue, std::string& aOutput) {
+            appendValue(aOutput, aValue.*apMember);
+        });
+        return *this;
+    }
+
+    /// \<input\> number for an arithmetic member
+    template<typename Number>
+    FormFields& number(const char* apName, const char* apLabel, Number T::* apMember) {
+        add(apName, apLabel, Input("number", apName), [apMember](const T& aValue, std::string& aOutput) {
+            appendValue(aOutput, std::to_string(aValue.*apMember));
+        });
+        return *this;
+    }
+
+    /// \<input\> checkbox for a bool member
+    FormFields& checkbox(const char* apName, const char* apLabel, bool T::* apMember) {
+        add(apName, apLabel, Input("checkbox", apName), [apMember](const T& aValue, std::string& aOutput) {
+            if (aValue.*apMember) {
+                aOutput += " checked";
+            }
+        });
+        return *this;
+    }
+
+    /// \<select\> for a string member, with the given value/label options
+    FormFields& select(const char* apName, const char* apLabel, std::string T::* apMember,
+                       std::initializer_list<std::pair<const char*, const char*>> aOptions) {
+        Select select(apName);
+        select.id(apName);
+        for (const auto& option : aOptions) {
+            const std::string value(option.first);
+            Option element(option.first, option.second);
+            element.addAttribute(marker([apMember, value](const T& aValue, std::string& aOutput) {
+                if (aValue.*apMember == value) {
+                    aOutput += " selected";
+                }
+            }).c_str(), "");
+            select << std::move(element);
+        }
+        add(apName, apLabel, std::move(select));
+        return *this;
+    }
+
+    /// \<input\> hidden for a string member, without label
+    FormFields& hidden(const char* apName, std::string T::* apMember) {
+        Input input("hidden", apName);
+        input.addAttribute(marker([apMember](const T& aValue, std::string& aOutput) {
+            appendValue(aOutput, aValue.*apMember);
+        }).c_str(), "");
+        mFields.push_back(std::move(input));
+        return *this;
+    }
+
+    /// Append the markup of the fields filled with the given struct
+    static void render(const T& aValue, std::string& aOutput) {
+        const Compiled& compiled = get();
+        aOutput.reserve(aOutput.size() + compiled.Size);
+        for (size_t idx = 0; idx < compiled.Slots.size(); ++idx) {
+            aOutput += compiled.Statics[idx];
+            compiled.Slots[idx](aValue, aOutput);
+        }
+        aOutput += compiled.Statics.back();
+    }
+
+private:
+    typedef std::function<void(const T& aValue, std::string& aOutput)> Slot;
+
+    /// Static markup split at the slots: Statics has one more item than Slots
+    struct Compiled {
+        std::vector<std::string>    Statics;
+        std::vector<Slot>           Slots;
+        size_t                      Size;   ///< Size of the static markup
+    };
+
+    /// Compiled fields of the type, built on first use (thread-safe)
+    static const Compiled& get() {
+        static const Compiled sCompiled = compile();
+        return sCompiled;
+    }
+
+    static Compiled compile() {
+        FormFields fields;
+        FormSchema<T>::describe(fields);
+
+        // Rendered with the compile-time layout, as the RenderContext of the Documents is not known yet
+        std::string markup;
+        RenderContext context;
+        for (const auto& field : fields.mFields) {
+            field.render(markup, context);
+        }
+        if (markup.size() >= context.Endline.size()) {
+            markup.resize(markup.size() - context.Endline.size());  // the end of line is added by the Text node
+        }
+
+        // Split at each " \x01<index>" marker attribute
+        Compiled compiled{{}, {}, 0};
+        size_t start = 0;
+        for (size_t marker = markup.find('\x01'); marker != std::string::npos; marker = markup.find('\x01', start)) {
+            compiled.Statics.push_back(markup.substr(start, marker - 1 - start));
+            compiled.Size += marker - 1 - start;
+            start = marker + 1;
+            size_t index = 0;
+            while ((start < markup.size()) && (markup[start] >= '0') && (markup[start] <= '9')) {
+                index = index * 10 + static_cast<size_t>(markup[start++] - '0');
+            }
+            compiled.Slots.push_back(fields.mSlots[index]);
+        }
+        compiled.Statics.push_back(markup.substr(start));
+        compiled.Size += markup.size() - start;
+        return compiled;
+    }
+
+    /// Register a slot, and return the name of the marker attribute to put where it goes
+    std::string marker(Slot aSlot) {
+        mSlots.push_back(std::move(aSlot));
+        return '\x01' + std::to_string(mSlots.size() - 1);
+    }
+
+    /// Add a field with its label, and the slot of its value or flag at the end of the attributes of the input
+    void add(const char* apName, const char* apLabel, Element&& aInput, Slot aSlot) {
+        aInput.id(apName);
+        aInput.addAttribute(marker(std::move(aSlot)).c_str(), "");
+        add(apName, apLabel, std::move(aInput));
+    }
+
+    void add(const char* apName, const char* apLabel, Element&& aInput) {
+        Element field("div");
+        if (mFieldClass) {
+            field.cls(mFieldClass);
+        }
+        field << Element("label", apLabel).addAttribute("for", apName);
+        field << std::move(aInput);
+        mFields.push_back(std::move(field));
+    }
+
+    /// Append a value attribute, escaped
+    static void appendValue(std::string& aOutput, const std::string& aValue) {
+        aOutput += " value=\"";
+        for (const char c : aValue) {
+            switch (c) {
+            case '&': aOutput += "&amp;"; break;
+            case '"': aOutput += "&quot;"; break;
+            case '<': aOutput += "&lt;"; break;
+            case '>': aOutput += "&gt;"; break;
+            default: aOutput += c; break;
+            }
+        }
+        aOutput += '"';
+    }
+
+private:
+    const char*             mFieldClass = nullptr;
+    std::vector<Element>    mFields;
+    std::vector<Slot>       mSlots;
+};
+
+/**
+ * @brief Form fields of a struct filled with its values, see FormSchema.
+ *
+ *   Like Options, the markup is one block built with HTML_ENDLINE and HTML_INDENTATION, whatever the Endline
+ * and Indentation of the RenderContext later used to render it, each line after the first one not being indented.
+ *
+ * @verbatim
+document << (HTML::Form("/user", "post") << HTML::FormOf<User>(user) << HTML::InputSubmit("Save")); @endverbatim
+ */
+template<typename T>
+class FormOf : public Element {
+public:
+    explicit FormOf(const T& aValue) : Element("") {
+        FormFields<T>::render(aValue, mContent);
+    }
+};
+
+} // namespace HTML
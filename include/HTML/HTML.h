@@ -15,5 +15,10 @@
  * @brief    A simple C++ header-only HTML Generator library, using a Document Object Model (DOM).
  */
 
+#include "RenderContext.h"
 #include "Element.h"
 #include "Document.h"
+
+// Note: the optional modules are not included here, so that their dependencies are paid only where they are used;
+// include the ones needed: Asset.h, Binary.h, Csv.h, Diff.h, FormSchema.h, Index.h, Intern.h, Options.h, Sha2.h,
+// Styles.h or TablePages.h.
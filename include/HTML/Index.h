@@ -0,0 +1,424 @@
+/**
+ * @file    Index.h
+ * @ingroup HtmlBuilder
+ * @brief   Lookup of Elements by id, class or tag, and simple CSS selector queries.
+ *
+ * Copyright (c) 2017-2021 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+ *
+ * Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+ * or copy at http://opensource.org/licenses/MIT)
+ */
+#pragma once
+
+#include "Element.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/// A simple C++ HTML Generator library.
+namespace HTML {
+
+/**
+ * @brief Index of the Elements of a tree by id, class and tag, to find and modify nodes after building a Document.
+ *
+ *   The index is built in one walk over the tree, then lookups are done in hash maps instead of walking the tree.
+ * Results are in document order. Shared subtrees are immutable and are not indexed.
+ *
+ *   The returned pointers stay valid as long as no child is added to or removed from the indexed tree,
+ * since that can reallocate the vectors of children; attributes can be modified freely through them.
+ * To keep a reference across such changes, use a Handle instead (see handleById() and handles()).
+ * Call rebuild() after changing the tree to index the new Elements, or after changing the id or class
+ * of an indexed Element.
+ *
+ *   select() supports a subset of CSS selectors: tag names, the universal selector '*', "#id" and ".class",
+ * combined into compound selectors like "td.total", and the descendant (' ') and child ('>') combinators.
+ */
+class Index {
+public:
+    /**
+     * @brief Reference to an Element of the tree, which stays valid when children are added anywhere in the tree.
+     *
+     *   Unlike a pointer, it does not depend on the addresses of the children, which move when a vector
+     * of children reallocates: it is the path of child positions from the root, resolved by get().
+     * Children are only ever appended, so these positions do not change, and the Index can even be destroyed.
+     * Once clear() has removed the Element or one of its ancestors, get() returns nullptr,
+     * or the Element appended since at the same position.
+     */
+    class Handle {
+    public:
+        bool operator==(const Handle& aOther) const {
+            return mPath == aOther.mPath;
+        }
+        bool operator!=(const Handle& aOther) const {
+            return mPath != aOther.mPath;
+        }
+
+    private:
+        friend class Index;
+        std::vector<size_t> mPath;  ///< Position of each Element among the children of its parent, from the root
+    };
+
+    explicit Index(Element& aRoot) : mRoot(aRoot) {
+        rebuild();
+    }
+
+    /// Walk the tree again to update the index after the tree has been modified
+    void rebuild() {
+        mNodes.clear();
+        mIds.clear();
+        mClasses.clear();
+        mTags.clear();
+        add(mRoot, NONE);
+    }
+
+    /// Number of indexed Elements
+    size_t size() const {
+        return mNodes.size();
+    }
+
+    /// First Element with the given id, or nullptr
+    Element* byId(const std::string& aId) const {
+        const auto found = mIds.find(aId);
+        return (found != mIds.end()) ? mNodes[found->second].pElement : nullptr;
+    }
+
+    /// Elements with the given class among their classes
+    std::vector<Element*> byClass(const std::string& aClass) const {
+        return elements(find(mClasses, aClass));
+    }
+
+    /// Elements with the given tag name
+    std::vector<Element*> byTag(const std::string& aTag) const {
+        return elements(find(mTags, aTag));
+    }
+
+    /**
+     * @brief Elements matching a CSS selector, like "table#scores > tr td.total".
+     *
+     *   The candidates for the last compound selector are taken from the index, then the combinators
+     * are checked by walking up the ancestors of each candidate. The results of these checks are remembered,
+     * so that it runs in linear time in the number of Elements times the number of compound selectors.
+     *
+     * @throw std::invalid_argument if the selector is empty or not supported
+     */
+    std::vector<Element*> select(const std::string& aSelector) const {
+        return elements(selectNodes(aSelector));
+    }
+
+    /// First Element matching a CSS selector, or nullptr
+    Element* selectFirst(const std::string& aSelector) const {
+        const std::vector<Element*> result = select(aSelector);
+        return result.empty() ? nullptr : result.front();
+    }
+
+    /// Handle to the first Element with the given id, or an invalid Handle (see get()) if there is none
+    Handle handleById(const std::string& aId) const {
+        const auto found = mIds.find(aId);
+        return (found != mIds.end()) ? handle(found->second) : Handle();
+    }
+
+    /// Handles to the Elements matching a CSS selector, see select()
+    std::vector<Handle> handles(const std::string& aSelector) const {
+        const std::vector<size_t> nodes = selectNodes(aSelector);
+        std::vector<Handle> result;
+        result.reserve(nodes.size());
+        for (const size_t node : nodes) {
+            result.push_back(handle(node));
+        }
+        return result;
+    }
+
+    /// Element referred to by the Handle, or nullptr if it has been removed (or if the Handle was never valid)
+    Element* get(const Handle& aHandle) const {
+        if (aHandle.mPath.empty()) {
+            return nullptr;
+        }
+        Element* pElement = &mRoot;
+        // The root itself is the first position of the path, always 0
+        for (size_t level = 1; level < aHandle.mPath.size(); ++level) {
+            if (aHandle.mPath[level] >= pElement->mChildren.size()) {
+                return nullptr;
+            }
+            pElement = &pElement->mChildren[aHandle.mPath[level]];
+        }
+        return pElement;
+    }
+
+private:
+    static const size_t NONE = static_cast<size_t>(-1);
+
+    /// Indexed Element, with the position of its parent in mNodes and its own among the children of its parent
+    struct Node {
+        Element*                    pElement;
+        size_t                      Parent;
+        size_t                      Position;
+        std::string                 Id;
+        std::vector<std::string>    Classes;
+    };
+
+    /// Compound selector, and the combinator linking it to the previous one
+    struct Compound {
+        std::string                 Tag;
+        std::string                 Id;
+        std::vector<std::string>    Classes;
+        bool                        bChild;
+    };
+
+    /// Element still to index, with the position of its parent in mNodes and its own among its siblings
+    struct Pending {
+        Element*    pElement;
+        size_t      Parent;
+        size_t      Position;
+    };
+
+    /// Index the tree in document order, with an explicit stack instead of recursion
+    void add(Element& aRoot, const size_t aParent) {
+        // Children are pushed in reverse order, to be indexed in document order
+        std::vector<Pending> pending(1, Pending{&aRoot, aParent, 0});
+        while (!pending.empty()) {
+            Element& element = *pending.back().pElement;
+            const size_t parent = pending.back().Parent;
+            const size_t position = pending.back().Position;
+            pending.pop_back();
+            if (element.shared() || element.mName.empty()) {
+                continue;
+            }
+            const size_t node = mNodes.size();
+            mNodes.push_back({&element, parent, position, std::string(), {}});
+            mTags[element.mName].push_back(node);
+            for (const auto& attr : element.mAttributes) {
+                if (attr.Name == "id") {
+                    if (mNodes[node].Id.empty()) {
+                        mNodes[node].Id = attr.value();
+                        mIds.insert(std::make_pair(attr.value(), node));
+                    }
+                } else if (attr.Name == "class") {
+                    size_t start = 0;
+                    while (start < attr.value().size()) {
+                        size_t end = attr.value().find(' ', start);
+                        if (end == std::string::npos) {
+                            end = attr.value().size();
+                        }
+                        if (end > start) {
+                            std::string cls = attr.value().substr(start, end - start);
+                            std::vector<size_t>& nodes = mClasses[cls];
+                            if (nodes.empty() || (nodes.back() != node)) {
+                                nodes.push_back(node);
+                            }
+                            mNodes[node].Classes.push_back(std::move(cls));
+                        }
+                        start = end + 1;
+                    }
+                }
+            }
+            for (size_t child = element.mChildren.size(); child > 0; --child) {
+                pending.push_back(Pending{&element.mChildren[child - 1], node, child - 1});
+            }
+        }
+    }
+
+    static const std::vector<size_t>& find(const std::unordered_map<std::string, std::vector<size_t>>& aMap,
+                                           const std::string& aKey) {
+        static const std::vector<size_t> sEmpty;
+        const auto found = aMap.find(aKey);
+        return (found != aMap.end()) ? found->second : sEmpty;
+    }
+
+    std::vector<Element*> elements(const std::vector<size_t>& aNodes) const {
+        std::vector<Element*> result;
+        result.reserve(aNodes.size());
+        for (const size_t node : aNodes) {
+            result.push_back(mNodes[node].pElement);
+        }
+        return result;
+    }
+
+    /// Handle to an indexed Element, from the positions of its ancestors
+    Handle handle(const size_t aNode) const {
+        Handle result;
+        for (size_t node = aNode; node != NONE; node = mNodes[node].Parent) {
+            result.mPath.push_back(mNodes[node].Position);
+        }
+        std::reverse(result.mPath.begin(), result.mPath.end());
+        return result;
+    }
+
+    /// Positions in mNodes of the Elements matching a CSS selector, see select()
+    std::vector<size_t> selectNodes(const std::string& aSelector) const {
+        const std::vector<Compound> compounds = parse(aSelector);
+        const Compound& last = compounds.back();
+        Memo memo;
+        std::vector<size_t> result;
+        if (!last.Id.empty()) {
+            const auto found = mIds.find(last.Id);
+            if ((found != mIds.end()) && matches(compounds, compounds.size() - 1, found->second, memo)) {
+                result.push_back(found->second);
+            }
+        } else if (!last.Classes.empty() || !last.Tag.empty()) {
+            const std::vector<size_t>& candidates = last.Classes.empty() ? find(mTags, last.Tag)
+                                                                         : find(mClasses, last.Classes.front());
+            for (const size_t node : candidates) {
+                if (matches(compounds, compounds.size() - 1, node, memo)) {
+                    result.push_back(node);
+                }
+            }
+        } else {
+            for (size_t node = 0; node < mNodes.size(); ++node) {
+                if (matches(compounds, compounds.size() - 1, node, memo)) {
+                    result.push_back(node);
+                }
+            }
+        }
+        return result;
+    }
+
+    /// Read the name (tag, id or class) starting at aStart, and return the position following it
+    static size_t readName(const std::string& aSelector, const size_t aStart, std::string& aName) {
+        size_t end = aStart;
+        while (end < aSelector.size()) {
+            const char c = aSelector[end];
+            if (((c >= 'a') && (c <= 'z')) || ((c >= 'A') && (c <= 'Z')) || ((c >= '0') && (c <= '9'))
+                || (c == '-') || (c == '_')) {
+                ++end;
+            } else {
+                break;
+            }
+        }
+        aName.assign(aSelector, aStart, end - aStart);
+        return end;
+    }
+
+    static std::vector<Compound> parse(const std::string& aSelector) {
+        std::vector<Compound> compounds;
+        size_t idx = 0;
+        bool bChild = false;
+        while (idx < aSelector.size()) {
+            const char c = aSelector[idx];
+            if (c == ' ') {
+                ++idx;
+            } else if (c == '>') {
+                if (compounds.empty() || bChild) {
+                    throw std::invalid_argument("HTML: unexpected '>' in selector " + aSelector);
+                }
+                bChild = true;
+                ++idx;
+            } else {
+                Compound compound{std::string(), std::string(), {}, bChild};
+                idx = (c == '*') ? idx + 1 : readName(aSelector, idx, compound.Tag);
+                while ((idx < aSelector.size()) && (aSelector[idx] != ' ') && (aSelector[idx] != '>')) {
+                    std::string name;
+                    const char prefix = aSelector[idx];
+                    idx = readName(aSelector, idx + 1, name);
+                    if (name.empty() || ((prefix != '#') && (prefix != '.'))) {
+                        throw std::invalid_argument("HTML: unsupported selector " + aSelector);
+                    }
+                    if (prefix == '#') {
+                        compound.Id = std::move(name);
+                    } else {
+                        compound.Classes.push_back(std::move(name));
+                    }
+                }
+                compounds.push_back(std::move(compound));
+                bChild = false;
+            }
+        }
+        if (compounds.empty() || bChild) {
+            throw std::invalid_argument("HTML: incomplete selector " + aSelector);
+        }
+        return compounds;
+    }
+
+    bool matchesCompound(const Compound& aCompound, const size_t aNode) const {
+        const Node& node = mNodes[aNode];
+        if (!aCompound.Tag.empty() && (aCompound.Tag != node.pElement->mName)) {
+            return false;
+        }
+        if (!aCompound.Id.empty() && (aCompound.Id != node.Id)) {
+            return false;
+        }
+        for (const auto& cls : aCompound.Classes) {
+            bool bFound = false;
+            for (const auto& nodeClass : node.Classes) {
+                bFound |= (nodeClass == cls);
+            }
+            if (!bFound) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// Results already known while matching a selector, keyed by aCompound * mNodes.size() + aNode
+    struct Memo {
+        std::unordered_map<size_t, bool> Matches;   ///< The node matches the compound selectors up to aCompound
+        std::unordered_map<size_t, bool> Ancestors; ///< The node or one of its ancestors matches them
+    };
+
+    /**
+     * @brief Check the compound selectors up to aCompound, from the node up through its ancestors.
+     *
+     *   Without the memo, each descendant combinator would try every ancestor again for each candidate
+     * and for each way of matching the compound selectors after it: exponential in the number of combinators.
+     * With it, each node is checked at most once for each compound selector, and the recursion is bounded
+     * by the number of compound selectors, not by the depth of the tree.
+     */
+    bool matches(const std::vector<Compound>& aCompounds, const size_t aCompound, const size_t aNode,
+                 Memo& aMemo) const {
+        const size_t key = aCompound * mNodes.size() + aNode;
+        const auto found = aMemo.Matches.find(key);
+        if (found != aMemo.Matches.end()) {
+            return found->second;
+        }
+        bool bMatch = matchesCompound(aCompounds[aCompound], aNode);
+        const size_t parent = mNodes[aNode].Parent;
+        if (bMatch && (aCompound > 0)) {
+            if (parent == NONE) {
+                bMatch = false;
+            } else if (aCompounds[aCompound].bChild) {
+                bMatch = matches(aCompounds, aCompound - 1, parent, aMemo);
+            } else {
+                bMatch = matchesUp(aCompounds, aCompound - 1, parent, aMemo);
+            }
+        }
+        aMemo.Matches[key] = bMatch;
+        return bMatch;
+    }
+
+    /// Check if the node or one of its ancestors matches the compound selectors up to aCompound
+    bool matchesUp(const std::vector<Compound>& aCompounds, const size_t aCompound, const size_t aNode,
+                   Memo& aMemo) const {
+        // Nodes walked up before finding the answer, which is then the same for all of them
+        std::vector<size_t> walked;
+        bool bMatch = false;
+        for (size_t node = aNode; node != NONE; node = mNodes[node].Parent) {
+            const auto found = aMemo.Ancestors.find(aCompound * mNodes.size() + node);
+            if (found != aMemo.Ancestors.end()) {
+                bMatch = found->second;
+                break;
+            }
+            walked.push_back(node);
+            if (matches(aCompounds, aCompound, node, aMemo)) {
+                bMatch = true;
+                break;
+            }
+        }
+        for (const size_t node : walked) {
+            aMemo.Ancestors[aCompound * mNodes.size() + node] = bMatch;
+        }
+        return bMatch;
+    }
+
+private:
+    Element&                                                mRoot;
+    std::vector<Node>                                       mNodes;     ///< Indexed Elements, in document order
+    std::unordered_map<std::string, size_t>                 mIds;
+    std::unordered_map<std::string, std::vector<size_t>>    mClasses;
+    std::unordered_map<std::string, std::vector<size_t>>    mTags;
+};
+
+} // namespace HTML
@@ -0,0 +1,57 @@
+/**
+ * @file    Intern.h
+ * @ingroup HtmlBuilder
+ * @brief   Pool of attribute values stored only once, used by Document::intern().
+ *
+ * Copyright (c) 2017-2021 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+ *
+ * Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+ * or copy at http://opensource.org/licenses/MIT)
+ */
+#pragma once
+
+#include "Document.h"
+
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+/// A simple C++ HTML Generator library.
+namespace HTML {
+
+/**
+ * @brief Hash set of the attribute values interned by Document::intern(), each stored only once.
+ *
+ *   Include this header to use Document::intern(), so that the other translation units do not pay
+ * for the hash set. The values are kept alive as long as an attribute refers to them.
+ */
+class InternPool {
+public:
+    /// Move the attribute values of the tree of at least aMinSize bytes to the pool, created on first use
+    static void intern(Element& aRoot, std::shared_ptr<InternPool>& apPool, const size_t aMinSize) {
+        if (!apPool) {
+            apPool = std::make_shared<InternPool>();
+        }
+        std::vector<Element*> pending(1, &aRoot);
+        while (!pending.empty()) {
+            Element& element = *pending.back();
+            pending.pop_back();
+            for (auto& attr : element.mAttributes) {
+                if (!attr.isShared() && (attr.value().size() >= aMinSize)) {
+                    // Aliasing constructor: the value is owned by the pool, kept alive as long as an attribute uses it
+                    const std::string& value = *apPool->mValues.insert(std::move(attr.ownValue())).first;
+                    attr.share(std::shared_ptr<const std::string>(apPool, &value));
+                }
+            }
+            for (auto& child : element.mChildren) {
+                pending.push_back(&child);
+            }
+        }
+    }
+
+private:
+    std::unordered_set<std::string> mValues;
+};
+
+} // namespace HTML
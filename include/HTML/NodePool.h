@@ -0,0 +1,187 @@
+/**
+ * @file    NodePool.h
+ * @ingroup HtmlBuilder
+ * @brief   Per-thread recycling of the buffers of the Elements, from one Document to the next.
+ *
+ * Copyright (c) 2017-2021 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+ *
+ * Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+ * or copy at http://opensource.org/licenses/MIT)
+ */
+#pragma once
+
+#include "Element.h"
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+/// A simple C++ HTML Generator library.
+namespace HTML {
+
+/**
+ * @brief Pool recycling the buffers of the Elements destroyed on the current thread, for the next Elements built.
+ *
+ *   While a NodePool is in scope, every Element destroyed on its thread gives its vectors of children
+ * and of attributes, and its heap-allocated strings, to the pool instead of freeing them. The Elements built
+ * afterwards on the same thread take them back: their content and attribute values are copied into recycled
+ * strings, and their vectors grow into recycled buffers. A service building and dropping a Document
+ * per request thus reaches a steady state where building a page of the same shape allocates next to nothing.
+ *
+ *   Buffers are sorted by capacity class (powers of two), and a buffer is only reused for a need of the same
+ * or the next class, so that a small Element never holds a large buffer. New buffers are rounded up
+ * to a power of two, so that a page of the same shape finds all the buffers it needs in the pool.
+ * Buffers remain ordinary allocations: an Element built while a pool is in scope can be moved to
+ * and destroyed on another thread.
+ *
+ *   A NodePool is used on the thread that constructs it, and pools on the same thread must be nested.
+ * Destroying it frees the buffers it holds.
+ *
+ * @verbatim
+void worker(Queue& aRequests) {
+    HTML::NodePool pool;
+    while (Request request = aRequests.pop()) {
+        HTML::Document document(request.title());
+        ...
+        request.reply(document.toString());
+    }   // the buffers of the Document go back to the pool
+} @endverbatim
+ */
+class NodePool : public Element::Recycler {
+public:
+    /// Start recycling on the current thread, keeping at most aMaxBuffers buffers
+    explicit NodePool(const size_t aMaxBuffers = 1000000) :
+        mpPrevious(Element::recycler()), mMaxBuffers(aMaxBuffers) {
+        Element::recycler() = this;
+    }
+    ~NodePool() override {
+        Element::recycler() = mpPrevious;
+    }
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+
+    /// Pool in scope on the current thread, or nullptr
+    static NodePool* current() {
+        return static_cast<NodePool*>(Element::recycler());
+    }
+
+    /// Number of buffers held, ready to be reused
+    size_t size() const {
+        return mNbBuffers;
+    }
+
+private:
+    void recycle(Element& aElement) override {
+        give(std::move(aElement.mChildren));
+        for (auto& attribute : aElement.mAttributes) {
+            if (!attribute.isShared()) {
+                give(std::move(attribute.ownValue()));
+            }
+        }
+        aElement.mAttributes.clear();
+        give(std::move(aElement.mAttributes));
+        give(std::move(aElement.mContent));
+    }
+    void grow(std::vector<Element>& aChildren, const size_t aCapacity) override {
+        swap(aChildren, mChildren.take(aCapacity, mNbBuffers));
+    }
+    void grow(std::vector<Element::Attribute>& aAttributes, const size_t aCapacity) override {
+        swap(aAttributes, mAttributes.take(aCapacity, mNbBuffers));
+    }
+    /// Copy of the text, in a recycled string if it does not fit in the string itself
+    std::string copy(const char* apText, const size_t aSize) override {
+        if (aSize <= std::string().capacity()) {
+            return std::string(apText, aSize);
+        }
+        std::string text = mStrings.take(aSize, mNbBuffers);
+        text.assign(apText, aSize);
+        return text;
+    }
+
+    /// Move the items to the larger buffer, which replaces the buffer given back to the pool
+    template<typename Buffer>
+    void swap(Buffer& aBuffer, Buffer&& aLarger) {
+        for (auto& item : aBuffer) {
+            aLarger.push_back(std::move(item));
+        }
+        aBuffer.clear();
+        aBuffer.swap(aLarger);
+        give(std::move(aLarger));
+    }
+
+    /// Buffers of one type, in buckets by capacity class
+    template<typename Buffer>
+    class FreeList {
+    public:
+        /// Recycled buffer with room for at least aCapacity items, or else a new one rounded up to a power of two
+        Buffer take(const size_t aCapacity, size_t& aNbBuffers) {
+            const size_t fit = ceilBucket(aCapacity);
+            for (size_t idx = fit; (idx < fit + 2) && (idx < NB_BUCKETS); ++idx) {
+                std::vector<Buffer>& buffers = mBuckets[idx];
+                if (!buffers.empty()) {
+                    Buffer buffer(std::move(buffers.back()));
+                    buffers.pop_back();
+                    --aNbBuffers;
+                    return buffer;
+                }
+            }
+            Buffer buffer;
+            buffer.reserve(size_t(1) << fit);
+            return buffer;
+        }
+        /// Keep an empty buffer
+        void give(Buffer&& aBuffer, size_t& aNbBuffers) {
+            mBuckets[floorBucket(aBuffer.capacity())].push_back(std::move(aBuffer));
+            ++aNbBuffers;
+        }
+
+    private:
+        static const size_t NB_BUCKETS = 8 * sizeof(size_t);
+
+        /// Capacity class: the bucket of a capacity c holds the buffers with 2^bucket <= c < 2^(bucket + 1)
+        static size_t floorBucket(size_t aCapacity) {
+            size_t bucket = 0;
+            while (aCapacity > 1) {
+                aCapacity >>= 1;
+                ++bucket;
+            }
+            return bucket;
+        }
+        /// First bucket of which all the buffers have room for the given capacity
+        static size_t ceilBucket(const size_t aCapacity) {
+            const size_t bucket = floorBucket(aCapacity);
+            return ((size_t(1) << bucket) < aCapacity) ? bucket + 1 : bucket;
+        }
+
+        std::vector<Buffer> mBuckets[NB_BUCKETS];
+    };
+
+    /// Keep the buffer of an empty vector or a string, if it has any and the pool is not full
+    void give(std::vector<Element>&& aChildren) {
+        if ((0 < aChildren.capacity()) && (mNbBuffers < mMaxBuffers)) {
+            mChildren.give(std::move(aChildren), mNbBuffers);
+        }
+    }
+    void give(std::vector<Element::Attribute>&& aAttributes) {
+        if ((0 < aAttributes.capacity()) && (mNbBuffers < mMaxBuffers)) {
+            mAttributes.give(std::move(aAttributes), mNbBuffers);
+        }
+    }
+    void give(std::string&& aString) {
+        if ((aString.capacity() > std::string().capacity()) && (mNbBuffers < mMaxBuffers)) {
+            aString.clear();
+            mStrings.give(std::move(aString), mNbBuffers);
+        }
+    }
+
+private:
+    Element::Recycler*                          mpPrevious; ///< Pool in scope before this one, restored at the end
+    size_t                                      mMaxBuffers;
+    size_t                                      mNbBuffers = 0;
+    FreeList<std::vector<Element>>              mChildren;
+    FreeList<std::vector<Element::Attribute>>   mAttributes;
+    FreeList<std::string>                       mStrings;
+};
+
+} // namespace HTML
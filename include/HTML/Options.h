@@ -0,0 +1,55 @@
+/**
+ * @file    Options.h
+ * @ingroup HtmlBuilder
+ * @brief   Block of many \<option\> for Select and DataList, built at once.
+ *
+ * Copyright (c) 2017-2021 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+ *
+ * Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+ * or copy at http://opensource.org/licenses/MIT)
+ */
+#pragma once
+
+#include "Element.h"
+
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <utility>
+
+/// A simple C++ HTML Generator library.
+namespace HTML {
+
+/**
+ * @brief Block of many \<option\> for Select and DataList, built at once from a range of value/label pairs.
+ *
+ *   The markup of all the options is built only once, one per line (only the first one being indented),
+ * without creating an Option Element for each, and it is then shared by all copies of the object,
+ * so that the same list can be reused in many forms at no cost. Selected values are looked up in a hash set.
+ * Being built before any rendering, the lines are separated by HTML_ENDLINE whatever the RenderContext.
+ *
+ * @verbatim
+const HTML::Options countries(codes.begin(), codes.end(), {"FR"}); // std::map<std::string, std::string> codes
+form << (HTML::Select("country") << HTML::Options(countries)); @endverbatim
+ */
+class Options : public Element {
+public:
+    template<typename Iterator>
+    Options(Iterator aBegin, Iterator aEnd, const std::unordered_set<std::string>& aSelected = {}) : Element("") {
+        std::string markup;
+        for (Iterator it = aBegin; it != aEnd; ++it) {
+            const std::string& value = it->first;
+            if (!markup.empty()) {
+                markup += HTML_ENDLINE;
+            }
+            markup += "<option value=\"";
+            markup += value;
+            markup += (aSelected.find(value) != aSelected.end()) ? "\" selected>" : "\">";
+            markup += it->second;
+            markup += "</option>";
+        }
+        mFlags.share(std::make_shared<const Element>(Text(std::move(markup))));
+    }
+};
+
+} // namespace HTML
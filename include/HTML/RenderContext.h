@@ -0,0 +1,231 @@
+/**
+ * @file    RenderContext.h
+ * @ingroup HtmlBuilder
+ * @brief   Options, reusable buffers and statistics passed through the whole render path.
+ *
+ * Copyright (c) 2017-2021 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+ *
+ * Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+ * or copy at http://opensource.org/licenses/MIT)
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+/// A simple C++ HTML Generator library.
+namespace HTML {
+
+// Note: to configure indentation & minification, define this at compile time before including HTML headers.
+#ifndef HTML_INDENTATION
+#define HTML_INDENTATION 2
+#endif
+#ifndef HTML_ENDLINE
+#define HTML_ENDLINE "\n"
+#endif
+// Note: maximum nesting depth accepted when visiting or rendering a tree, see Element::visit().
+#ifndef HTML_MAX_DEPTH
+#define HTML_MAX_DEPTH 100000
+#endif
+
+/**
+ * @brief Options, reusable buffers and statistics passed through the whole render path.
+ *
+ *   A worker thread can keep its own RenderContext to render page after page with no setup cost
+ * and no state shared with other threads. The rendering functions without a RenderContext parameter
+ * use the default context of the current thread, see local().
+ *
+ *   Texts and attribute values can optionally be validated as UTF-8, and non-ASCII characters encoded
+ * as numeric entities, in the same single pass copying them to the output. The raw text of \<script\>
+ * and \<style\> Elements, where entities are not decoded, is encoded with JavaScript and CSS escapes instead.
+ */
+class RenderContext {
+public:
+    /// Policy for invalid UTF-8 in texts and attribute values
+    enum class Utf8Policy {
+        Trust,      ///< Copy texts as they are, without any validation (default)
+        Replace,    ///< Replace each invalid byte by the replacement character U+FFFD
+        Reject      ///< Throw a std::invalid_argument exception
+    };
+
+    /// Syntax of a text, deciding how non-ASCII characters are encoded for ASCII-only outputs
+    enum class Syntax {
+        Html,       ///< Text or attribute value, as a numeric entity like "&#xE9;"
+        Script,     ///< Raw text of a \<script\>, as a JavaScript escape like "\u00E9" (surrogate pairs above U+FFFF)
+        Style       ///< Raw text of a \<style\>, as a CSS escape like "\E9 " (ended by a space)
+    };
+
+    explicit RenderContext(const size_t aIndentation = HTML_INDENTATION, const char* apEndline = HTML_ENDLINE) :
+        Indentation(aIndentation), Endline(apEndline) {
+    }
+
+    /// Default context of the current thread, configured at compile time by HTML_INDENTATION and HTML_ENDLINE
+    static RenderContext& local() {
+        thread_local RenderContext sContext;
+        return sContext;
+    }
+
+    /// Syntax of the content of the Element with the given tag name: only relevant for ASCII-only outputs
+    Syntax syntax(const char* apName, const size_t aSize) const {
+        if (!AsciiOnly) {
+            return Syntax::Html;
+        } else if ((6 == aSize) && (0 == std::memcmp(apName, "script", 6))) {
+            return Syntax::Script;
+        } else if ((5 == aSize) && (0 == std::memcmp(apName, "style", 5))) {
+            return Syntax::Style;
+        }
+        return Syntax::Html;
+    }
+    Syntax syntax(const std::string& aName) const {
+        return syntax(aName.data(), aName.size());
+    }
+
+    /**
+     * @brief Append a text or an attribute value to the output, applying the UTF-8 and ASCII options.
+     *
+     *   Runs of ASCII characters are checked 8 bytes at a time and copied at once,
+     * so that clean ASCII texts are copied nearly as fast as with a memcpy.
+     *
+     * @param[in] aSyntax   Syntax of the text, see syntax(), to encode non-ASCII characters for ASCII-only outputs
+     */
+    void append(std::string& aOutput, const char* apText, const size_t aSize,
+                const Syntax aSyntax = Syntax::Html) const {
+        if ((Utf8Policy::Trust == Utf8) && !AsciiOnly) {
+            aOutput.append(apText, aSize);
+            return;
+        }
+        size_t idx = 0;
+        while (idx < aSize) {
+            size_t end = idx;
+            uint64_t word;
+            while ((end + sizeof(word) <= aSize)
+                && (0 == (std::memcpy(&word, apText + end, sizeof(word)), word & 0x8080808080808080ULL))) {
+                end += sizeof(word);
+            }
+            while ((end < aSize) && (0 == (apText[end] & 0x80))) {
+                ++end;
+            }
+            aOutput.append(apText + idx, end - idx);
+            idx = end;
+            if (idx < aSize) {
+                uint32_t codePoint = 0;
+                const size_t length = decodeUtf8(reinterpret_cast<const unsigned char*>(apText + idx),
+                                                 aSize - idx, codePoint);
+                if (0 == length) {
+                    if (Utf8Policy::Reject == Utf8) {
+                        throw std::invalid_argument("HTML: invalid UTF-8 sequence");
+                    }
+                    appendCodePoint(aOutput, 0xFFFD, "\xEF\xBF\xBD", 3, aSyntax);
+                    ++idx;
+                } else {
+                    appendCodePoint(aOutput, codePoint, apText + idx, length, aSyntax);
+                    idx += length;
+                }
+            }
+        }
+    }
+    void append(std::string& aOutput, const std::string& aText, const Syntax aSyntax = Syntax::Html) const {
+        append(aOutput, aText.data(), aText.size(), aSyntax);
+    }
+
+    /**
+     * @brief Decode the UTF-8 sequence at the start of the text (RFC 3629, without overlong forms nor surrogates).
+     *
+     * @return Length of the sequence, or 0 if it is invalid
+     */
+    static size_t decodeUtf8(const unsigned char* apText, const size_t aSize, uint32_t& aCodePoint) {
+        const unsigned char first = apText[0];
+        size_t length;
+        unsigned char min = 0x80;
+        unsigned char max = 0xBF;
+        if (first < 0x80) {
+            aCodePoint = first;
+            return 1;
+        } else if ((0xC2 <= first) && (first <= 0xDF)) {
+            length = 2;
+            aCodePoint = first & 0x1Fu;
+        } else if ((0xE0 <= first) && (first <= 0xEF)) {
+            length = 3;
+            aCodePoint = first & 0x0Fu;
+            min = (0xE0 == first) ? 0xA0 : 0x80;
+            max = (0xED == first) ? 0x9F : 0xBF;
+        } else if ((0xF0 <= first) && (first <= 0xF4)) {
+            length = 4;
+            aCodePoint = first & 0x07u;
+            min = (0xF0 == first) ? 0x90 : 0x80;
+            max = (0xF4 == first) ? 0x8F : 0xBF;
+        } else {
+            return 0;
+        }
+        if (aSize < length) {
+            return 0;
+        }
+        for (size_t idx = 1; idx < length; ++idx) {
+            const unsigned char next = apText[idx];
+            if ((next < min) || (next > max)) {
+                return 0;
+            }
+            min = 0x80;
+            max = 0xBF;
+            aCodePoint = (aCodePoint << 6u) | (next & 0x3Fu);
+        }
+        return length;
+    }
+
+    // Note: blocks of markup built once before any rendering, Options and FormOf, do not follow the layout below:
+    // their lines are separated by the compile-time HTML_ENDLINE, and only their first line is indented.
+    size_t      Indentation;    ///< Number of spaces added for each level of children
+    std::string Endline;        ///< End of line added after each line
+
+    Utf8Policy  Utf8 = Utf8Policy::Trust;   ///< Validation of UTF-8 in texts and attribute values
+    bool        AsciiOnly = false;  ///< Encode non-ASCII characters as numeric entities (invalid UTF-8 is replaced)
+    size_t      MaxDepth = HTML_MAX_DEPTH;  ///< Rendering a tree nested deeper throws a std::length_error
+
+    size_t      NbNodes = 0;    ///< Statistics: number of nodes rendered with this context
+    size_t      NbBytes = 0;    ///< Statistics: number of bytes rendered with this context
+
+    std::string Buffer;         ///< Scratch buffer reused, keeping its capacity, to render to a std::ostream
+
+private:
+    /// Append a valid character, either as its UTF-8 sequence or escaped in the given syntax for ASCII-only outputs
+    void appendCodePoint(std::string& aOutput, const uint32_t aCodePoint,
+                         const char* apUtf8, const size_t aSize, const Syntax aSyntax) const {
+        if (!AsciiOnly) {
+            aOutput.append(apUtf8, aSize);
+        } else if (Syntax::Script == aSyntax) {
+            // UTF-16 code units, as a surrogate pair above U+FFFF
+            if (aCodePoint > 0xFFFFu) {
+                appendHex(aOutput, "\\u", 0xD800u + ((aCodePoint - 0x10000u) >> 10u), 4, "");
+                appendHex(aOutput, "\\u", 0xDC00u + ((aCodePoint - 0x10000u) & 0x3FFu), 4, "");
+            } else {
+                appendHex(aOutput, "\\u", aCodePoint, 4, "");
+            }
+        } else if (Syntax::Style == aSyntax) {
+            // The space ends the escape, so that a following hexadecimal digit is not taken as part of it
+            appendHex(aOutput, "\\", aCodePoint, 1, " ");
+        } else {
+            appendHex(aOutput, "&#x", aCodePoint, 1, ";");
+        }
+    }
+
+    /// Append the prefix, the code in uppercase hexadecimal with at least aNbDigits digits, and the suffix
+    static void appendHex(std::string& aOutput, const char* apPrefix, const uint32_t aCode, const int aNbDigits,
+                          const char* apSuffix) {
+        static const char sDigits[] = "0123456789ABCDEF";
+        char digits[8];  // "10FFFF" at most
+        size_t length = 0;
+        for (int shift = 20; shift >= 0; shift -= 4) {
+            if (((aCode >> shift) != 0) || (length > 0) || (shift < 4 * aNbDigits)) {
+                digits[length++] = sDigits[(aCode >> shift) & 0xFu];
+            }
+        }
+        aOutput += apPrefix;
+        aOutput.append(digits, length);
+        aOutput += apSuffix;
+    }
+};
+
+} // namespace HTML
@@ -0,0 +1,232 @@
+/**
+ * @file    Sha2.h
+ * @ingroup HtmlBuilder
+ * @brief   SHA-256, SHA-384 and SHA-512 hashes (FIPS 180-4), for Subresource Integrity.
+ *
+ * Copyright (c) 2017-2021 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+ *
+ * Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+ * or copy at http://opensource.org/licenses/MIT)
+ */
+#pragma once
+
+#include "Digest.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/// A simple C++ HTML Generator library.
+namespace HTML {
+
+/**
+ * @brief Incremental SHA-2 hash of a stream of data.
+ *
+ * @verbatim
+HTML::Sha2 sha(HTML::Digest::Sha384);
+sha.update(apData, aSize);
+const std::string digest = sha.finish(); // 48 raw bytes @endverbatim
+ */
+class Sha2 {
+public:
+    explicit Sha2(const Digest aDigest) : mDigest(aDigest) {
+        static const uint64_t sInit256[8] = {
+            0x6a09e667u, 0xbb67ae85u, 0x3c6ef372u, 0xa54ff53au, 0x510e527fu, 0x9b05688cu, 0x1f83d9abu, 0x5be0cd19u
+        };
+        static const uint64_t sInit384[8] = {
+            0xcbbb9d5dc1059ed8ULL, 0x629a292a367cd507ULL, 0x9159015a3070dd17ULL, 0x152fecd8f70e5939ULL,
+            0x67332667ffc00b31ULL, 0x8eb44a8768581511ULL, 0xdb0c2e0d64f98fa7ULL, 0x47b5481dbefa4fa4ULL
+        };
+        static const uint64_t sInit512[8] = {
+            0x6a09e667f3bcc908ULL, 0xbb67ae8584caa73bULL, 0x3c6ef372fe94f82bULL, 0xa54ff53a5f1d36f1ULL,
+            0x510e527fade682d1ULL, 0x9b05688c2b3e6c1fULL, 0x1f83d9abfb41bd6bULL, 0x5be0cd19137e2179ULL
+        };
+        const uint64_t* pInit = (Digest::Sha256 == aDigest) ? sInit256
+                              : (Digest::Sha384 == aDigest) ? sInit384 : sInit512;
+        for (size_t idx = 0; idx < 8; ++idx) {
+            mState[idx] = pInit[idx];
+        }
+    }
+
+    /// Add data to the hash
+    void update(const char* apData, size_t aSize) {
+        const unsigned char* pData = reinterpret_cast<const unsigned char*>(apData);
+        const size_t blockSize = this->blockSize();
+        mLength += aSize;
+        if (0 < mBuffered) {
+            while ((mBuffered < blockSize) && (0 < aSize)) {
+                mBuffer[mBuffered++] = *pData++;
+                --aSize;
+            }
+            if (mBuffered == blockSize) {
+                compress(mBuffer);
+                mBuffered = 0;
+            }
+        }
+        for (; aSize >= blockSize; aSize -= blockSize, pData += blockSize) {
+            compress(pData);
+        }
+        while (0 < aSize) {
+            mBuffer[mBuffered++] = *pData++;
+            --aSize;
+        }
+    }
+
+    /// Finish the hash, and return the raw bytes of the digest (32, 48 or 64 bytes)
+    std::string finish() {
+        const size_t blockSize = this->blockSize();
+        const size_t lengthSize = blockSize / 8;  // 64 or 128 bits
+        const uint64_t bits = static_cast<uint64_t>(mLength) * 8u;
+        unsigned char padding[2 * 128] = {0x80};
+        size_t paddingSize = blockSize - mBuffered;
+        if (paddingSize < 1 + lengthSize) {
+            paddingSize += blockSize;
+        }
+        for (size_t idx = 0; idx < 8; ++idx) {
+            padding[paddingSize - 1 - idx] = static_cast<unsigned char>(bits >> (8 * idx));
+        }
+        const size_t length = mLength;
+        update(reinterpret_cast<const char*>(padding), paddingSize);
+        mLength = length;
+
+        const size_t wordSize = (Digest::Sha256 == mDigest) ? 4 : 8;
+        const size_t nbWords = (Digest::Sha384 == mDigest) ? 6 : 8;
+        std::string digest;
+        digest.reserve(wordSize * nbWords);
+        for (size_t word = 0; word < nbWords; ++word) {
+            for (size_t byte = wordSize; byte > 0; --byte) {
+                digest += static_cast<char>((mState[word] >> (8 * (byte - 1))) & 0xFFu);
+            }
+        }
+        return digest;
+    }
+
+    /// Name of the algorithm, as used in an integrity attribute
+    static const char* name(const Digest aDigest) {
+        switch (aDigest) {
+        case Digest::Sha256: return "sha256";
+        case Digest::Sha384: return "sha384";
+        case Digest::Sha512: return "sha512";
+        default: return "";
+        }
+    }
+
+private:
+    size_t blockSize() const {
+        return (Digest::Sha256 == mDigest) ? 64 : 128;
+    }
+
+    static uint32_t rotr(const uint32_t aValue, const unsigned int aBits) {
+        return (aValue >> aBits) | (aValue << (32u - aBits));
+    }
+    static uint64_t rotr(const uint64_t aValue, const unsigned int aBits) {
+        return (aValue >> aBits) | (aValue << (64u - aBits));
+    }
+
+    void compress(const unsigned char* apBlock) {
+        if (Digest::Sha256 == mDigest) {
+            compress256(apBlock);
+        } else {
+            compress512(apBlock);
+        }
+    }
+
+    void compress256(const unsigned char* apBlock) {
+        static const uint32_t sK[64] = {
+            0x428a2f98u, 0x71374491u, 0xb5c0fbcfu, 0xe9b5dba5u, 0x3956c25bu, 0x59f111f1u, 0x923f82a4u, 0xab1c5ed5u,
+            0xd807aa98u, 0x12835b01u, 0x243185beu, 0x550c7dc3u, 0x72be5d74u, 0x80deb1feu, 0x9bdc06a7u, 0xc19bf174u,
+            0xe49b69c1u, 0xefbe4786u, 0x0fc19dc6u, 0x240ca1ccu, 0x2de92c6fu, 0x4a7484aau, 0x5cb0a9dcu, 0x76f988dau,
+            0x983e5152u, 0xa831c66du, 0xb00327c8u, 0xbf597fc7u, 0xc6e00bf3u, 0xd5a79147u, 0x06ca6351u, 0x14292967u,
+            0x27b70a85u, 0x2e1b2138u, 0x4d2c6dfcu, 0x53380d13u, 0x650a7354u, 0x766a0abbu, 0x81c2c92eu, 0x92722c85u,
+            0xa2bfe8a1u, 0xa81a664bu, 0xc24b8b70u, 0xc76c51a3u, 0xd192e819u, 0xd6990624u, 0xf40e3585u, 0x106aa070u,
+            0x19a4c116u, 0x1e376c08u, 0x2748774cu, 0x34b0bcb5u, 0x391c0cb3u, 0x4ed8aa4au, 0x5b9cca4fu, 0x682e6ff3u,
+            0x748f82eeu, 0x78a5636fu, 0x84c87814u, 0x8cc70208u, 0x90befffau, 0xa4506cebu, 0xbef9a3f7u, 0xc67178f2u,
+        };
+        uint32_t w[64];
+        for (size_t t = 0; t < 16; ++t) {
+            w[t] = (static_cast<uint32_t>(apBlock[4 * t]) << 24u) | (static_cast<uint32_t>(apBlock[4 * t + 1]) << 16u)
+                 | (static_cast<uint32_t>(apBlock[4 * t + 2]) << 8u) | static_cast<uint32_t>(apBlock[4 * t + 3]);
+        }
+        for (size_t t = 16; t < 64; ++t) {
+            const uint32_t s0 = rotr(w[t - 15], 7) ^ rotr(w[t - 15], 18) ^ (w[t - 15] >> 3u);
+            const uint32_t s1 = rotr(w[t - 2], 17) ^ rotr(w[t - 2], 19) ^ (w[t - 2] >> 10u);
+            w[t] = w[t - 16] + s0 + w[t - 7] + s1;
+        }
+        uint32_t v[8];
+        for (size_t idx = 0; idx < 8; ++idx) {
+            v[idx] = static_cast<uint32_t>(mState[idx]);
+        }
+        for (size_t t = 0; t < 64; ++t) {
+            const uint32_t t1 = v[7] + (rotr(v[4], 6) ^ rotr(v[4], 11) ^ rotr(v[4], 25))
+                              + ((v[4] & v[5]) ^ (~v[4] & v[6])) + sK[t] + w[t];
+            const uint32_t t2 = (rotr(v[0], 2) ^ rotr(v[0], 13) ^ rotr(v[0], 22))
+                              + ((v[0] & v[1]) ^ (v[0] & v[2]) ^ (v[1] & v[2]));
+            v[7] = v[6]; v[6] = v[5]; v[5] = v[4]; v[4] = v[3] + t1;
+            v[3] = v[2]; v[2] = v[1]; v[1] = v[0]; v[0] = t1 + t2;
+        }
+        for (size_t idx = 0; idx < 8; ++idx) {
+            mState[idx] = static_cast<uint32_t>(mState[idx] + v[idx]);
+        }
+    }
+
+    void compress512(const unsigned char* apBlock) {
+        static const uint64_t sK[80] = {
+            0x428a2f98d728ae22ULL, 0x7137449123ef65cdULL, 0xb5c0fbcfec4d3b2fULL, 0xe9b5dba58189dbbcULL,
+            0x3956c25bf348b538ULL, 0x59f111f1b605d019ULL, 0x923f82a4af194f9bULL, 0xab1c5ed5da6d8118ULL,
+            0xd807aa98a3030242ULL, 0x12835b0145706fbeULL, 0x243185be4ee4b28cULL, 0x550c7dc3d5ffb4e2ULL,
+            0x72be5d74f27b896fULL, 0x80deb1fe3b1696b1ULL, 0x9bdc06a725c71235ULL, 0xc19bf174cf692694ULL,
+            0xe49b69c19ef14ad2ULL, 0xefbe4786384f25e3ULL, 0x0fc19dc68b8cd5b5ULL, 0x240ca1cc77ac9c65ULL,
+            0x2de92c6f592b0275ULL, 0x4a7484aa6ea6e483ULL, 0x5cb0a9dcbd41fbd4ULL, 0x76f988da831153b5ULL,
+            0x983e5152ee66dfabULL, 0xa831c66d2db43210ULL, 0xb00327c898fb213fULL, 0xbf597fc7beef0ee4ULL,
+            0xc6e00bf33da88fc2ULL, 0xd5a79147930aa725ULL, 0x06ca6351e003826fULL, 0x142929670a0e6e70ULL,
+            0x27b70a8546d22ffcULL, 0x2e1b21385c26c926ULL, 0x4d2c6dfc5ac42aedULL, 0x53380d139d95b3dfULL,
+            0x650a73548baf63deULL, 0x766a0abb3c77b2a8ULL, 0x81c2c92e47edaee6ULL, 0x92722c851482353bULL,
+            0xa2bfe8a14cf10364ULL, 0xa81a664bbc423001ULL, 0xc24b8b70d0f89791ULL, 0xc76c51a30654be30ULL,
+            0xd192e819d6ef5218ULL, 0xd69906245565a910ULL, 0xf40e35855771202aULL, 0x106aa07032bbd1b8ULL,
+            0x19a4c116b8d2d0c8ULL, 0x1e376c085141ab53ULL, 0x2748774cdf8eeb99ULL, 0x34b0bcb5e19b48a8ULL,
+            0x391c0cb3c5c95a63ULL, 0x4ed8aa4ae3418acbULL, 0x5b9cca4f7763e373ULL, 0x682e6ff3d6b2b8a3ULL,
+            0x748f82ee5defb2fcULL, 0x78a5636f43172f60ULL, 0x84c87814a1f0ab72ULL, 0x8cc702081a6439ecULL,
+            0x90befffa23631e28ULL, 0xa4506cebde82bde9ULL, 0xbef9a3f7b2c67915ULL, 0xc67178f2e372532bULL,
+            0xca273eceea26619cULL, 0xd186b8c721c0c207ULL, 0xeada7dd6cde0eb1eULL, 0xf57d4f7fee6ed178ULL,
+            0x06f067aa72176fbaULL, 0x0a637dc5a2c898a6ULL, 0x113f9804bef90daeULL, 0x1b710b35131c471bULL,
+            0x28db77f523047d84ULL, 0x32caab7b40c72493ULL, 0x3c9ebe0a15c9bebcULL, 0x431d67c49c100d4cULL,
+            0x4cc5d4becb3e42b6ULL, 0x597f299cfc657e2aULL, 0x5fcb6fab3ad6faecULL, 0x6c44198c4a475817ULL,
+        };
+        uint64_t w[80];
+        for (size_t t = 0; t < 16; ++t) {
+            w[t] = 0;
+            for (size_t byte = 0; byte < 8; ++byte) {
+                w[t] = (w[t] << 8u) | apBlock[8 * t + byte];
+            }
+        }
+        for (size_t t = 16; t < 80; ++t) {
+            const uint64_t s0 = rotr(w[t - 15], 1) ^ rotr(w[t - 15], 8) ^ (w[t - 15] >> 7u);
+            const uint64_t s1 = rotr(w[t - 2], 19) ^ rotr(w[t - 2], 61) ^ (w[t - 2] >> 6u);
+            w[t] = w[t - 16] + s0 + w[t - 7] + s1;
+        }
+        uint64_t v[8];
+        for (size_t idx = 0; idx < 8; ++idx) {
+            v[idx] = mState[idx];
+        }
+        for (size_t t = 0; t < 80; ++t) {
+            const uint64_t t1 = v[7] + (rotr(v[4], 14) ^ rotr(v[4], 18) ^ rotr(v[4], 41))
+                              + ((v[4] & v[5]) ^ (~v[4] & v[6])) + sK[t] + w[t];
+            const uint64_t t2 = (rotr(v[0], 28) ^ rotr(v[0], 34) ^ rotr(v[0], 39))
+                              + ((v[0] & v[1]) ^ (v[0] & v[2]) ^ (v[1] & v[2]));
+            v[7] = v[6]; v[6] = v[5]; v[5] = v[4]; v[4] = v[3] + t1;
+            v[3] = v[2]; v[2] = v[1]; v[1] = v[0]; v[0] = t1 + t2;
+        }
+        for (size_t idx = 0; idx < 8; ++idx) {
+            mState[idx] += v[idx];
+        }
+    }
+
+private:
+    Digest          mDigest;
+    uint64_t        mState[8];          ///< Hash values (32 bits words stored in 64 bits for SHA-256)
+    unsigned char   mBuffer[128];       ///< Partial block waiting for more data
+    size_t          mBuffered = 0;
+    size_t          mLength = 0;        ///< Total number of bytes hashed
+};
+
+} // namespace HTML
@@ -0,0 +1,144 @@
+/**
+ * @file    Styles.h
+ * @ingroup HtmlBuilder
+ * @brief   Hoisting of repeated inline styles into generated classes, used by Document::hoistStyles().
+ *
+ * Copyright (c) 2017-2021 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+ *
+ * Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+ * or copy at http://opensource.org/licenses/MIT)
+ */
+#pragma once
+
+#include "Document.h"
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/// A simple C++ HTML Generator library.
+namespace HTML {
+
+/**
+ * @brief Pass of Document::hoistStyles() over the tree, with its hash maps.
+ *
+ *   Include this header to use Document::hoistStyles(), so that the other translation units do not pay
+ * for the hash maps.
+ */
+class StyleHoister {
+public:
+    /// Replace the inline style values repeated in the Document by generated classes, see Document::hoistStyles()
+    static void hoist(Document& aDocument, const std::string& aPrefix) {
+        std::vector<std::pair<std::string, std::string>>& hoisted = aDocument.mHoistedStyles;
+        StyleHoister hoister;
+        for (const auto& style : hoisted) {
+            hoister.mClasses.insert(style);
+        }
+        hoister.count(aDocument);
+        const size_t nbHoisted = hoisted.size();
+        hoister.replace(aDocument, aPrefix, hoisted);
+        if (hoisted.empty()) {
+            return;
+        }
+        // The <style> added by the previous calls, if it is still there: only the new rules are appended to it
+        std::vector<Element>& head = static_cast<Element&>(aDocument.head()).mChildren;
+        const size_t position = aDocument.mHoistedStyle;
+        const std::string first = rule(hoisted.front());
+        const bool bFound = (0 < nbHoisted) && (position < head.size()) && (head[position].mName == "style")
+                         && (0 == head[position].mContent.compare(0, first.size(), first));
+        std::string css;
+        for (size_t idx = bFound ? nbHoisted : 0; idx < hoisted.size(); ++idx) {
+            css += rule(hoisted[idx]);
+        }
+        if (bFound) {
+            head[position].mContent += css;
+        } else if (!css.empty()) {
+            aDocument.mHoistedStyle = head.size();
+            aDocument.head() << Style(css);
+        }
+    }
+
+private:
+    /// CSS rule of a hoisted style value and its class
+    static std::string rule(const std::pair<std::string, std::string>& aStyle) {
+        return '.' + aStyle.second + '{' + aStyle.first + '}';
+    }
+
+    /// Count the occurrences of each inline style value in the tree
+    void count(const Element& aRoot) {
+        std::vector<const Element*> pending(1, &aRoot);
+        while (!pending.empty()) {
+            const Element& element = *pending.back();
+            pending.pop_back();
+            for (const auto& attr : element.mAttributes) {
+                if (attr.Name == "style") {
+                    ++mCounts[attr.value()];
+                }
+            }
+            for (const auto& child : element.mChildren) {
+                pending.push_back(&child);
+            }
+        }
+    }
+
+    /// The style value is to be replaced by a class: it is used more than once, or it already has a class
+    bool isHoisted(const Element::Attribute& aAttr) const {
+        return (aAttr.Name == "style")
+            && ((1 < mCounts.find(aAttr.value())->second) || (0 != mClasses.count(aAttr.value())));
+    }
+
+    /// Replace the inline style values to hoist with a class, adding each new class after aHoisted
+    void replace(Element& aRoot, const std::string& aPrefix,
+                 std::vector<std::pair<std::string, std::string>>& aHoisted) {
+        // Depth-first in document order, so that the classes are numbered in the order of the Elements
+        std::vector<Element*> pending(1, &aRoot);
+        std::vector<std::string> classes;
+        while (!pending.empty()) {
+            Element& element = *pending.back();
+            pending.pop_back();
+            for (auto child = element.mChildren.rbegin(); child != element.mChildren.rend(); ++child) {
+                pending.push_back(&*child);
+            }
+            std::vector<Element::Attribute>& attributes = element.mAttributes;
+            classes.clear();
+            for (const auto& attr : attributes) {
+                if (isHoisted(attr)) {
+                    std::string& cls = mClasses[attr.value()];
+                    if (cls.empty()) {
+                        cls = aPrefix + std::to_string(aHoisted.size());
+                        aHoisted.push_back(std::make_pair(attr.value(), cls));
+                    }
+                    classes.push_back(cls);
+                }
+            }
+            if (classes.empty()) {
+                continue;
+            }
+            attributes.erase(std::remove_if(attributes.begin(), attributes.end(), [&](const Element::Attribute& aAttr) {
+                return isHoisted(aAttr);
+            }), attributes.end());
+            auto attrClass = std::find_if(attributes.begin(), attributes.end(), [](const Element::Attribute& aAttr) {
+                return aAttr.Name == "class";
+            });
+            if (attrClass == attributes.end()) {
+                attributes.push_back({"class", ""});
+                attrClass = attributes.end() - 1;
+            }
+            std::string& value = attrClass->ownValue();
+            for (const auto& cls : classes) {
+                if (!value.empty()) {
+                    value += ' ';
+                }
+                value += cls;
+            }
+        }
+    }
+
+    std::unordered_map<std::string, size_t>         mCounts;    ///< Number of uses of each inline style value
+    std::unordered_map<std::string, std::string>    mClasses;   ///< Class generated for each hoisted style value,
+                                                                ///< by this call or a previous one
+};
+
+} // namespace HTML
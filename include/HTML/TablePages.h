@@ -0,0 +1,136 @@
+/**
+ * @file    TablePages.h
+ * @ingroup HtmlBuilder
+ * @brief   Paginated rendering of a Table with a large number of Rows.
+ *
+ * Copyright (c) 2017-2021 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+ *
+ * Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+ * or copy at http://opensource.org/licenses/MIT)
+ */
+#pragma once
+
+#include "Element.h"
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+
+/// A simple C++ HTML Generator library.
+namespace HTML {
+
+/**
+ * @brief Split a large dataset into pages of a Table, each with a pagination Nav.
+ *
+ *   Rows are built on demand by a row source, only for the requested page,
+ * so the Rows of the other pages are never materialized.
+ * The Caption and the header Row are built only once and shared by all the pages.
+ *
+ * @verbatim
+TablePages pages([&](const size_t aIndex) { return HTML::Row() << HTML::Col(data[aIndex]); }, data.size(), 100);
+pages.caption(HTML::Caption("Data")).header(HTML::Row() << HTML::ColHeader("Value"));
+pages.forEachPage([](const size_t aPage) { return "page" + std::to_string(aPage) + ".html"; },
+                  [](const size_t aPage, HTML::Table&& aTable, HTML::Nav&& aNav) { ... }); @endverbatim
+ */
+class TablePages {
+public:
+    /// Build the Row at the given index of the dataset
+    typedef std::function<Row(const size_t aIndex)> RowSource;
+    /// Give the URL of the given page, for the pagination links
+    typedef std::function<std::string(const size_t aPage)> PageUrl;
+    /// Receive each page of the dataset, see forEachPage()
+    typedef std::function<void(const size_t aPage, Table&& aTable, Nav&& aNav)> PageCallback;
+
+    TablePages(RowSource aRowSource, const size_t aNbRows, const size_t aPageSize) :
+        mRowSource(std::move(aRowSource)), mNbRows(aNbRows), mPageSize(std::max<size_t>(aPageSize, 1)) {
+    }
+
+    TablePages& caption(Caption&& aCaption) {
+        mpCaption = share(std::move(aCaption));
+        return *this;
+    }
+    TablePages& header(Row&& aRow) {
+        mpHeader = share(std::move(aRow));
+        return *this;
+    }
+    TablePages& cls(const std::string& aValue) {
+        mClass = aValue;
+        return *this;
+    }
+
+    size_t nbPages() const {
+        return (mNbRows + mPageSize - 1) / mPageSize;
+    }
+
+    /// Table with the Caption, the header and only the Rows of the given page
+    Table table(const size_t aPage) const {
+        Page page(mpCaption, mpHeader);
+        if (!mClass.empty()) {
+            page.cls(mClass);
+        }
+        const size_t first = std::min(aPage * mPageSize, mNbRows);
+        const size_t last = std::min(first + mPageSize, mNbRows);
+        page.reserve(last - first + 2);
+        for (size_t index = first; index < last; ++index) {
+            page << mRowSource(index);
+        }
+        return std::move(page);
+    }
+
+    /// Pagination Nav to the previous, the next and the few pages around the given one
+    Nav nav(const size_t aPage, const PageUrl& aUrl) const {
+        List list(false, "pagination");
+        if (0 < aPage) {
+            list << item("Previous", aUrl(aPage - 1), false);
+        }
+        const size_t first = (2 < aPage) ? aPage - 2 : 0;
+        const size_t last = std::min(aPage + 3, nbPages());
+        for (size_t page = first; page < last; ++page) {
+            list << item(std::to_string(page + 1), aUrl(page), page == aPage);
+        }
+        if (aPage + 1 < nbPages()) {
+            list << item("Next", aUrl(aPage + 1), false);
+        }
+        Nav nav;
+        nav << std::move(list);
+        return nav;
+    }
+
+    /// Build every page of the dataset in a single pass, for instance to write each one in a separate Document
+    void forEachPage(const PageUrl& aUrl, const PageCallback& aCallback) const {
+        for (size_t page = 0; page < nbPages(); ++page) {
+            aCallback(page, table(page), nav(page, aUrl));
+        }
+    }
+
+private:
+    /// Table starting with the shared Caption and header Row
+    class Page : public Table {
+    public:
+        Page(const std::shared_ptr<const Element>& apCaption, const std::shared_ptr<const Element>& apHeader) {
+            if (apCaption) {
+                addChild(Shared(apCaption));
+            }
+            if (apHeader) {
+                addChild(Shared(apHeader));
+            }
+        }
+    };
+
+    static ListItem item(const std::string& aText, const std::string& aUrl, const bool abActive) {
+        return ListItem().cls(abActive ? "page-item active" : "page-item")
+            << Link(aText, aUrl).cls("page-link");
+    }
+
+private:
+    RowSource                       mRowSource;
+    size_t                          mNbRows;
+    size_t                          mPageSize;
+    std::string                     mClass;
+    std::shared_ptr<const Element>  mpCaption;
+    std::shared_ptr<const Element>  mpHeader;
+};
+
+} // namespace HTML
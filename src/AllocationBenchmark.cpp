@@ -0,0 +1,112 @@
+/**
+ * @file    AllocationBenchmark.cpp
+ * @ingroup HtmlBuilder
+ * @brief   Number of heap allocations and time to build, render and drop a page, without and with a NodePool.
+ *
+ *   The global operator new is replaced to count the allocations. The same page, a table of links
+ * with classes and inline styles, is built and dropped again and again, first without recycling,
+ * then with a NodePool in scope: once warmed up, the pool must remove nearly all the allocations.
+ * Usage: HtmlBuilder_allocation_benchmark [NB_PAGES]
+ *
+ * Copyright (c) 2017-2021 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+ *
+ * Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+ * or copy at http://opensource.org/licenses/MIT)
+ */
+
+#include <HTML/HTML.h>
+#include <HTML/NodePool.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <utility>
+
+namespace {
+
+/// Number of calls to the global operator new
+size_t sNbAllocations = 0;
+
+/// Build a page of 200 rows, render it into the output and drop it; the URLs are built in a buffer of the caller
+void renderPage(const size_t aPage, std::string& aUrl, std::string& aOutput) {
+    HTML::Document document("Allocation benchmark, a title too long for the small string optimization");
+    document.head() << HTML::Rel("stylesheet", "https://cdn.example.com/css/bootstrap.min.css", "text/css");
+    document << HTML::Header1("Page " + std::to_string(aPage));
+    HTML::Table table;
+    table.cls("table table-striped table-hover");
+    table << (HTML::Row() << HTML::ColHeader("Rank") << HTML::ColHeader("Name") << HTML::ColHeader("Link"));
+    for (unsigned int row = 0; row < 200; ++row) {
+        aUrl.assign("https://www.example.com/items/").append(std::to_string(row));
+        table << (HTML::Row().cls("row-item")
+            << HTML::Col(row).style("text-align:right;padding-right:4px")
+            << HTML::Col("A name long enough to be allocated on the heap")
+            << (HTML::Col() << HTML::Link("details", aUrl)
+                                   .cls("link-secondary text-decoration-none")));
+    }
+    document << std::move(table);
+    aOutput.clear();
+    document.render(aOutput, HTML::RenderContext::local());
+}
+
+/// Mean number of allocations and time per page, measured after warming up
+void measure(const char* apName, const size_t aNbPages, double& aAllocationsPerPage) {
+    std::string url;
+    std::string output;
+    for (size_t page = 0; page < 10; ++page) {
+        renderPage(page, url, output);
+    }
+    const size_t nbAllocations = sNbAllocations;
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t page = 0; page < aNbPages; ++page) {
+        renderPage(page, url, output);
+    }
+    const auto end = std::chrono::steady_clock::now();
+    aAllocationsPerPage = static_cast<double>(sNbAllocations - nbAllocations) / static_cast<double>(aNbPages);
+    const auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    std::cout << apName << ": " << aAllocationsPerPage << " allocations and "
+              << static_cast<double>(duration) / static_cast<double>(aNbPages) << " us per page" << std::endl;
+}
+
+} // namespace
+
+void* operator new(const size_t aSize) {
+    ++sNbAllocations;
+    if (void* pMemory = std::malloc(aSize ? aSize : 1)) {
+        return pMemory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* apMemory) noexcept {
+    std::free(apMemory);
+}
+
+void operator delete(void* apMemory, size_t) noexcept {
+    std::free(apMemory);
+}
+
+/**
+ * @brief Entry-point of the allocation benchmark.
+ *
+ * @param[in] argc  Number of arguments
+ * @param[in] argv  Optional number of pages to measure
+ */
+int main(int argc, char* argv[]) {
+    const size_t nbPages = (1 < argc) ? std::strtoul(argv[1], nullptr, 10) : 200;
+
+    double withoutPool = 0;
+    double withPool = 0;
+    measure("without NodePool", nbPages, withoutPool);
+    {
+        HTML::NodePool pool;
+        measure("with NodePool", nbPages, withPool);
+        std::cout << pool.size() << " buffers kept by the NodePool between pages" << std::endl;
+    }
+    if (withPool > withoutPool / 100) {
+        std::cerr << "The NodePool does not remove the allocations of the nodes" << std::endl;
+        return 1;
+    }
+    return 0;
+}
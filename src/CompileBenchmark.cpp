@@ -0,0 +1,32 @@
+/**
+ * @file    CompileBenchmark.cpp
+ * @ingroup HtmlBuilder
+ * @brief   Typical translation unit generating a page, compiled by compile_benchmark.sh in both modes.
+ *
+ *   It includes only Document.h, like most of the code generating HTML: the optional tools (Asset, Diff, Binary,
+ * Index...) and their standard headers are only brought by their own headers, in both modes.
+ *
+ * Copyright (c) 2017-2021 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+ *
+ * Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+ * or copy at http://opensource.org/licenses/MIT)
+ */
+
+#include <HTML/Document.h>
+
+#include <string>
+
+/// Render a page with a form and a table of scores
+std::string renderScores(const std::string& aTitle, const unsigned int aNbRows) {
+    HTML::Document document(aTitle);
+    document.lang("en");
+    document << HTML::Header1(aTitle);
+    document << (HTML::Form("/search") << HTML::Input("text", "query") << HTML::InputSubmit("Search"));
+    HTML::Table table;
+    table << (HTML::Row() << HTML::ColHeader("Rank") << HTML::ColHeader("Score"));
+    for (unsigned int row = 0; row < aNbRows; ++row) {
+        table << (HTML::Row() << HTML::Col(std::to_string(row + 1)) << HTML::Col(std::to_string(100 - row)));
+    }
+    document << std::move(table);
+    return document.toString();
+}
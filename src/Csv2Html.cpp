@@ -0,0 +1,97 @@
+/**
+ * @file    Csv2Html.cpp
+ * @ingroup HtmlBuilder
+ * @brief   Command-line tool converting a CSV or TSV file into an HTML table report.
+ *
+ *   Usage: HtmlBuilder_csv2html [--tsv] [--no-header] [--class <names>] [--title <title>] <file.csv|-> [output.html]
+ *
+ * Copyright (c) 2017-2021 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+ *
+ * Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+ * or copy at http://opensource.org/licenses/MIT)
+ */
+
+#include <HTML/HTML.h>
+#include <HTML/Csv.h>
+
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+/**
+ * @brief Entry-point of the tool.
+ *
+ * @param[in] argc  Number of arguments
+ * @param[in] argv  Options, input file ("-" for the standard input) and optional output file
+ */
+int main(int argc, char* argv[]) {
+    HTML::CsvTable converter;
+    std::string title("Report");
+    const char* pInput = nullptr;
+    const char* pOutput = nullptr;
+    for (int arg = 1; arg < argc; ++arg) {
+        if (0 == std::strcmp(argv[arg], "--tsv")) {
+            converter.delimiter('\t');
+        } else if (0 == std::strcmp(argv[arg], "--no-header")) {
+            converter.header(false);
+        } else if ((0 == std::strcmp(argv[arg], "--class")) && (arg + 1 < argc)) {
+            converter.cls(argv[++arg]);
+        } else if ((0 == std::strcmp(argv[arg], "--title")) && (arg + 1 < argc)) {
+            title = argv[++arg];
+        } else if (!pInput) {
+            pInput = argv[arg];
+        } else {
+            pOutput = argv[arg];
+        }
+    }
+    if (!pInput) {
+        std::cerr << "Usage: " << argv[0]
+                  << " [--tsv] [--no-header] [--class <names>] [--title <title>] <file.csv|-> [output.html]\n";
+        return 1;
+    }
+
+    std::ifstream file;
+    if (0 != std::strcmp(pInput, "-")) {
+        file.open(pInput, std::ios::binary);
+        if (!file) {
+            std::cerr << "Cannot open " << pInput << std::endl;
+            return 1;
+        }
+    }
+    std::istream& input = file.is_open() ? file : std::cin;
+    std::ofstream output;
+    if (pOutput) {
+        output.open(pOutput, std::ios::binary);
+        if (!output) {
+            std::cerr << "Cannot create " << pOutput << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& out = output.is_open() ? output : std::cout;
+
+    // The table is streamed in place of a placeholder line, between the two halves of the rendered Document,
+    // indented as a child of the <body> (the <html> root being at depth 0)
+    static const char sPlaceholder[] = "<!-- table -->";
+    static const size_t sBodyChildDepth = 2;
+    HTML::Document document(title);
+    document.head() << HTML::Meta("utf-8");
+    document << HTML::Text(sPlaceholder);
+    const std::string page = document.toString();
+    const size_t placeholder = page.find(sPlaceholder);
+    const size_t line = placeholder - sBodyChildDepth * HTML::RenderContext::local().Indentation;
+    const size_t after = placeholder + sizeof(sPlaceholder) - 1 + std::strlen(HTML_ENDLINE);
+
+    const auto start = std::chrono::steady_clock::now();
+    out.write(page.data(), static_cast<std::streamsize>(line));
+    HTML::RenderContext context;
+    const size_t nbRows = converter.depth(sBodyChildDepth).convert(input, out, context);
+    out.write(page.data() + after, static_cast<std::streamsize>(page.size() - after));
+    out.flush();
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cerr << nbRows << " rows, " << context.NbBytes << " bytes of HTML in " << seconds << " s ("
+              << (static_cast<double>(context.NbBytes) / 1e6 / (seconds > 0 ? seconds : 1)) << " MB/s)" << std::endl;
+    return out ? 0 : 1;
+}
@@ -0,0 +1,1136 @@
+/**
+ * @file    Fuzz.cpp
+ * @ingroup HtmlBuilder
+ * @brief   Differential fuzzing harness checking that every render path produces the same HTML.
+ *
+ *   Random Element trees are built from a buffer of bytes, then rendered through each available path,
+ * and the results are compared byte for byte with a simple recursive reference serializer.
+ * By default, it runs offline on pseudo-random buffers (the seed and the number of iterations can be given
+ * on the command line); built with HTML_LIBFUZZER defined, it is a libFuzzer target instead.
+ *
+ * Copyright (c) 2017-2021 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+ *
+ * Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+ * or copy at http://opensource.org/licenses/MIT)
+ */
+
+#include <HTML/HTML.h>
+#include <HTML/Asset.h>
+#include <HTML/Binary.h>
+#include <HTML/Csv.h>
+#include <HTML/Diff.h>
+#include <HTML/FormSchema.h>
+#include <HTML/Index.h>
+#include <HTML/Intern.h>
+#include <HTML/NodePool.h>
+#include <HTML/Options.h>
+#include <HTML/Styles.h>
+#include <HTML/TablePages.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
+namespace {
+
+/// Struct rendered by FormOf, with each kind of field
+struct Account {
+    std::string     Name;
+    unsigned int    Age;
+    bool            bAdmin;
+    std::string     Role;
+    std::string     Token;
+};
+
+} // namespace
+
+namespace HTML {
+template<> struct FormSchema<Account> {
+    static void describe(FormFields<Account>& aFields) {
+        aFields.fieldClass("field")
+               .input("text", "name", "Name", &Account::Name)
+               .number("age", "Age", &Account::Age)
+               .checkbox("admin", "Admin", &Account::bAdmin)
+               .select("role", "Role", &Account::Role, {{"user", "User"}, {"admin", "Admin"}})
+               .hidden("token", &Account::Token);
+    }
+};
+} // namespace HTML
+
+namespace {
+
+/// Compile-time check that a Child can be added to a Parent with operator<<
+template<typename Parent, typename Child, typename = void>
+struct Accepts : std::false_type {};
+template<typename Parent, typename Child>
+struct Accepts<Parent, Child, decltype(void(std::declval<Parent>() << std::declval<Child>()))> : std::true_type {};
+
+// The chained setters keep the type of the Element, so that restricted parents still accept it
+static_assert(Accepts<HTML::Select, decltype(HTML::Option("v", "l").id("x").selected())>::value, "Option setters");
+static_assert(Accepts<HTML::DataList, decltype(HTML::Option("v").cls("c").title("t"))>::value, "Option setters");
+static_assert(Accepts<HTML::Row, decltype(HTML::Col("c").cls("c").colSpan(2).style("s"))>::value, "Col setters");
+static_assert(Accepts<HTML::Row, decltype(HTML::ColHeader("h").id("h").rowSpan(2))>::value, "ColHeader setters");
+static_assert(Accepts<HTML::List, decltype(HTML::ListItem("i").cls("c").id("i"))>::value, "ListItem setters");
+// while restricted parents themselves refuse other children, even after a setter
+static_assert(!Accepts<HTML::Table, decltype(HTML::Table().cls("t"))>::value, "Table restricts its children");
+static_assert(!Accepts<decltype(HTML::Table().cls("t")), HTML::Div>::value, "Table restricts its children");
+static_assert(!Accepts<HTML::Select, decltype(HTML::Div().id("x"))>::value, "Select restricts its children");
+
+/// Build random Element trees by consuming a buffer of bytes
+class Generator {
+public:
+    Generator(const uint8_t* apData, const size_t aSize) : mpData(apData), mSize(aSize) {}
+
+    /// Random tree of Elements covering all kinds of nodes: void, text, empty content, nested children...
+    HTML::Element element(const size_t aDepth = 0) {
+        switch (pick(40)) {
+        case 0:  return HTML::Text(text());
+        case 1:  return HTML::Break();
+        case 2:  return HTML::Image(text(), text(), pick(3), pick(3));
+        case 3:  return HTML::InputText("name", text().c_str()).placeholder(text());
+        case 4:  return HTML::InputCheckbox("name").checked(0 < pick(2));
+        case 5:  return HTML::Paragraph(text()).style(text());
+        case 6:  return HTML::Link(text(), text()).cls(text());
+        case 7:  return HTML::Small(text());
+        case 8:  return HTML::Strong(text());
+        case 9:  return HTML::Header1(text()).id(text());
+        case 10: return HTML::Span(text());
+        case 11: return HTML::Pre(text());
+        case 12: return HTML::Button(text().c_str());
+        case 13: return HTML::Progress(pick(10), 10);
+        case 14: return HTML::Time(text(), text());
+        case 15: return table(aDepth);
+        case 16: return list(aDepth);
+        case 17: return select();
+        case 18: return HTML::Shared(HTML::share(children(HTML::Div(), aDepth)));
+        case 19: return children(HTML::Paragraph(text()), aDepth);
+        case 20: return children(HTML::Section(), aDepth);
+        case 21: return children(HTML::Details(0 < pick(2) ? "" : nullptr) << HTML::Summary(text()), aDepth);
+        case 22: return children(HTML::Form("/", "post"), aDepth);
+        case 23: return HTML::Script(0 < pick(2) ? "/app.js" : nullptr, text().c_str()).crossorigin(text());
+        case 24: return HTML::Rel("stylesheet", text().c_str(), "text/css").integrity(text());
+        case 25: return HTML::Base(text(), text(), 0 < pick(2) ? "_blank" : nullptr);
+        case 26: return HTML::Header2(text());
+        case 27: return HTML::Header3(text());
+        case 28: return HTML::Bold(text());
+        case 29: return HTML::Italic(text());
+        case 30: return HTML::Mark(text());
+        case 31: return HTML::Meter(pick(10), pick(3), 10);
+        case 32: return HTML::TextArea("area", pick(3), pick(3)).maxlength(pick(100));
+        case 33: return input();
+        case 34: return datalist();
+        case 35: return slots(aDepth);
+        case 36: return appended(aDepth);
+        case 37: return HTML::Form("/account", "post") << HTML::FormOf<Account>(account());
+        case 38: return shared(aDepth);
+        default:
+            switch (pick(4)) {
+            case 0:  return children(HTML::Nav(text().c_str()), aDepth);
+            case 1:  return children(HTML::Aside(), aDepth);
+            case 2:  return children(HTML::Figure() << HTML::FigCaption(text()), aDepth);
+            default: return children(HTML::Div(text().c_str()), aDepth);
+            }
+        }
+    }
+
+    /// Random Document with a random body
+    void document(HTML::Document& aDocument) {
+        aDocument.head() << HTML::Meta("utf-8");
+        if (0 < pick(2)) {
+            aDocument.head() << HTML::Style(text());
+        }
+        const size_t nbChildren = pick(6);
+        for (size_t child = 0; child < nbChildren; ++child) {
+            aDocument << element(1);
+        }
+    }
+
+    /// Random records of a CSV file, with cells containing delimiters, quotes, line breaks or markup
+    std::vector<std::vector<std::string>> records() {
+        static const char* const sWords[] = {"", "a", "1.5", ",", "\t", "\"", "\n", "\r\n", "<b>", "&", " x "};
+        std::vector<std::vector<std::string>> records(pick(6));
+        for (auto& record : records) {
+            record.resize(1 + pick(4));
+            for (auto& cell : record) {
+                const size_t nbWords = pick(3);
+                for (size_t word = 0; word < nbWords; ++word) {
+                    cell += sWords[pick(sizeof(sWords) / sizeof(sWords[0]))];
+                }
+            }
+        }
+        return records;
+    }
+
+    /// Number in [0, aMax[ taken from the buffer, or 0 when the buffer is exhausted
+    unsigned int pick(const size_t aMax) {
+        if (mIndex >= mSize) {
+            return 0;
+        }
+        return static_cast<unsigned int>(mpData[mIndex++] % aMax);
+    }
+
+private:
+    HTML::Element&& children(HTML::Element&& aElement, const size_t aDepth) {
+        const size_t nbChildren = (aDepth < 6) ? pick(5) : 0;
+        for (size_t child = 0; child < nbChildren; ++child) {
+            aElement << element(aDepth + 1);
+        }
+        return std::move(aElement);
+    }
+
+    HTML::Table table(const size_t aDepth) {
+        HTML::Table table;
+        if (0 < pick(2)) {
+            table << HTML::Caption(text().c_str());
+        }
+        const size_t nbRows = pick(4);
+        for (size_t row = 0; row < nbRows; ++row) {
+            HTML::Row line;
+            const size_t nbCols = pick(4);
+            for (size_t col = 0; col < nbCols; ++col) {
+                if (0 == pick(3)) {
+                    line << HTML::ColHeader(text()).colSpan(pick(3));
+                } else if (aDepth < 6 && 0 == pick(3)) {
+                    line << (HTML::Col() << element(aDepth + 1));
+                } else {
+                    line << HTML::Col(text()).rowSpan(pick(3));
+                }
+            }
+            table << std::move(line);
+        }
+        return table;
+    }
+
+    HTML::List list(const size_t aDepth) {
+        HTML::List list(0 < pick(2));
+        const size_t nbItems = pick(4);
+        for (size_t item = 0; item < nbItems; ++item) {
+            if (aDepth < 6 && 0 == pick(3)) {
+                list << (HTML::ListItem() << element(aDepth + 1));
+            } else {
+                list << HTML::ListItem(text());
+            }
+        }
+        return list;
+    }
+
+    HTML::Select select() {
+        HTML::Select select("select");
+        const size_t nbOptions = pick(4);
+        for (size_t option = 0; option < nbOptions; ++option) {
+            select << HTML::Option(text().c_str(), text().c_str()).selected(0 == pick(3));
+        }
+        return select;
+    }
+
+    /// One of the kinds of \<input\>, with some of their attributes
+    HTML::Input input() {
+        switch (pick(12)) {
+        case 0:  return HTML::InputRadio("radio", text().c_str(), text().c_str()).checked(0 < pick(2));
+        case 1:  return HTML::InputHidden("hidden", text().c_str());
+        case 2:  return HTML::InputNumber("number", text().c_str()).min(pick(3)).max(10);
+        case 3:  return HTML::InputRange("range").min(text()).max(text());
+        case 4:  return HTML::InputDate("date", text().c_str()).required();
+        case 5:  return HTML::InputTime("time").disabled();
+        case 6:  return HTML::InputEmail("email", text().c_str()).size(pick(40));
+        case 7:  return HTML::InputUrl("url").readonly().autofocus();
+        case 8:  return HTML::InputPassword("password").autocomplete().maxlength(pick(20));
+        case 9:  return HTML::InputSubmit(text().c_str());
+        case 10: return HTML::InputReset(text().c_str()).cls(text());
+        default: return HTML::InputList("list", "datalist").title(text());
+        }
+    }
+
+    /// Options given one by one or as a block of pre-rendered markup
+    HTML::Options options() {
+        std::map<std::string, std::string> labels;
+        std::unordered_set<std::string> selected;
+        const size_t nbOptions = pick(4);
+        for (size_t option = 0; option < nbOptions; ++option) {
+            const std::string value = std::to_string(pick(10));
+            labels[value] = text();
+            if (0 == pick(3)) {
+                selected.insert(value);
+            }
+        }
+        return HTML::Options(labels.begin(), labels.end(), selected);
+    }
+
+    HTML::DataList datalist() {
+        HTML::DataList datalist("datalist");
+        const size_t nbOptions = pick(4);
+        for (size_t option = 0; option < nbOptions; ++option) {
+            if (0 == pick(3)) {
+                datalist << options();
+            } else {
+                datalist << HTML::Option(text().c_str()).title(text());
+            }
+        }
+        return datalist;
+    }
+
+    /// Child slots, some of them left empty as placeholders
+    HTML::Element slots(const size_t aDepth) {
+        HTML::Element div = HTML::Div();
+        if (0 < pick(2)) {
+            div << HTML::Span(text());
+        }
+        const size_t nbSlots = pick(4);
+        const size_t first = div.addSlots(nbSlots);
+        for (size_t slot = 0; slot < nbSlots; ++slot) {
+            if ((aDepth < 6) && (0 < pick(2))) {
+                div.slot(first + slot) = element(aDepth + 1);
+            }
+        }
+        return div;
+    }
+
+    /// Text appended in pieces, to the content, to the last Text child, or as a new Text child
+    HTML::Element appended(const size_t aDepth) {
+        HTML::Element paragraph = HTML::Paragraph(text());
+        const size_t nbPieces = pick(6);
+        for (size_t piece = 0; piece < nbPieces; ++piece) {
+            switch (pick(4)) {
+            case 0:  paragraph.append(text()); break;
+            case 1:  paragraph.append(text().c_str()); break;
+            case 2:  paragraph.reserveText(pick(16)).append("pi\xC3\xA8" "ce", 5); break;
+            default:
+                if (aDepth < 6) {
+                    paragraph << element(aDepth + 1);
+                }
+                break;
+            }
+        }
+        return paragraph;
+    }
+
+    /// Same subtree shared twice in a container, and within a list item
+    HTML::Element shared(const size_t aDepth) {
+        const std::shared_ptr<const HTML::Element> pShared = HTML::share(children(HTML::Span(text()), aDepth));
+        HTML::Element div = HTML::Div();
+        div << HTML::Shared(pShared) << HTML::Text(text()) << HTML::Shared(pShared);
+        div << (HTML::List() << (HTML::ListItem() << HTML::Shared(pShared)));
+        if (0 < pick(2)) {
+            div << (HTML::Select("options") << options());
+        }
+        return div;
+    }
+
+    Account account() {
+        return Account{text(), pick(100), 0 < pick(2), (0 < pick(2)) ? "admin" : text(), text()};
+    }
+
+    /// Short text, often empty, possibly with special or non-ASCII characters
+    std::string text() {
+        static const char* const sWords[] = {"", "", "a", "text", "<b>", "&amp;", " ", "\xC3\xA9t\xC3\xA9", "\"q\""};
+        std::string text;
+        const size_t nbWords = pick(3);
+        for (size_t word = 0; word < nbWords; ++word) {
+            text += sWords[pick(sizeof(sWords) / sizeof(sWords[0]))];
+        }
+        return text;
+    }
+
+private:
+    const uint8_t*  mpData;
+    size_t          mSize;
+    size_t          mIndex = 0;
+};
+
+/**
+ * @brief Reference serializer: the original recursive std::ostream implementation, through the public accessors.
+ *
+ *   Kept as simple as possible, so that the optimized render paths are all checked against it.
+ */
+void serialize(std::ostream& aStream, const HTML::Element& aElement, const size_t aIndentation = 0) {
+    if (aElement.shared()) {
+        serialize(aStream, *aElement.shared(), aIndentation);
+        return;
+    }
+    if (aElement.name().empty()) {
+        if (!aElement.isVoid()) {
+            std::fill_n(std::ostream_iterator<char>(aStream), aIndentation, ' ');
+            aStream << aElement.content() << HTML_ENDLINE;
+        }
+        return;
+    }
+
+    std::fill_n(std::ostream_iterator<char>(aStream), aIndentation, ' ');
+    aStream << '<' << aElement.name();
+    for (const auto& attr : aElement.attributes()) {
+        aStream << ' ' << attr.Name;
+        if (!attr.value().empty()) {
+            aStream << "=\"" << attr.value() << "\"";
+        }
+    }
+    if (aElement.content().empty()) {
+        if (!aElement.children().empty() || aElement.isVoid()) {
+            aStream << ">" HTML_ENDLINE;
+        } else {
+            aStream << ">";
+        }
+    } else {
+        aStream << '>';
+    }
+
+    aStream << aElement.content();
+    for (const auto& child : aElement.children()) {
+        serialize(aStream, child, aIndentation + HTML_INDENTATION);
+    }
+
+    if (!aElement.children().empty()) {
+        std::fill_n(std::ostream_iterator<char>(aStream), aIndentation, ' ');
+    }
+    if (!aElement.content().empty() || !aElement.children().empty() || !aElement.isVoid()) {
+        aStream << "</" << aElement.name() << ">" HTML_ENDLINE;
+    }
+}
+
+std::string serialize(const HTML::Element& aElement) {
+    std::ostringstream stream;
+    serialize(stream, aElement);
+    return stream.str();
+}
+
+/// Compare the result of a render path with the reference, and report any difference
+bool check(const std::string& aReference, const std::string& aResult, const char* apPath) {
+    if (aResult != aReference) {
+        std::cerr << "Render path '" << apPath << "' differs from the reference serializer:\n"
+                  << aReference << "\n----\n" << aResult << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/// Mutable copy of a tree to apply Diff patches to, inserted and replaced subtrees being kept as HTML
+struct Node {
+    std::string                         Name;
+    std::string                         Content;
+    bool                                bVoid = false;
+    std::map<std::string, std::string>  Attributes;     ///< First occurrence of each attribute, as parsed by browsers
+    std::vector<Node>                   Children;
+    bool                                bRaw = false;   ///< Inserted or replaced node, of which only Html is known
+    std::string                         Html;
+
+    explicit Node(const HTML::Element& aElement) {
+        const HTML::Element& element = aElement.shared() ? *aElement.shared() : aElement;
+        Name = element.name();
+        Content = element.content();
+        bVoid = element.isVoid();
+        for (const auto& attr : element.attributes()) {
+            Attributes.insert(std::make_pair(attr.Name, attr.value()));
+        }
+        for (const auto& child : element.children()) {
+            Children.emplace_back(child);
+        }
+    }
+    explicit Node(const std::string& aHtml) : bRaw(true), Html(aHtml) {}
+
+    /// Same tree as the Element, raw nodes being compared to its HTML
+    bool equals(const HTML::Element& aElement) const {
+        const HTML::Element& element = aElement.shared() ? *aElement.shared() : aElement;
+        if (bRaw) {
+            return Html == serialize(element);
+        }
+        if ((Name != element.name()) || (Content != element.content()) || (bVoid != element.isVoid())
+         || (Children.size() != element.children().size())) {
+            return false;
+        }
+        std::map<std::string, std::string> attributes;
+        for (const auto& attr : element.attributes()) {
+            attributes.insert(std::make_pair(attr.Name, attr.value()));
+        }
+        if (Attributes != attributes) {
+            return false;
+        }
+        for (size_t idx = 0; idx < Children.size(); ++idx) {
+            if (!Children[idx].equals(element.children()[idx])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// Apply a patch to the tree, returning false if its Path does not lead to a node that it can edit
+    bool apply(const HTML::Diff::Patch& aPatch) {
+        typedef HTML::Diff::Patch::Operation Operation;
+        const bool bChild = (Operation::Insert == aPatch.Op) || (Operation::Remove == aPatch.Op);
+        if (bChild && aPatch.Path.empty()) {
+            return false;
+        }
+        Node* pNode = this;
+        for (size_t idx = 0; idx + (bChild ? 1 : 0) < aPatch.Path.size(); ++idx) {
+            if (pNode->bRaw || (aPatch.Path[idx] >= pNode->Children.size())) {
+                return false;
+            }
+            pNode = &pNode->Children[aPatch.Path[idx]];
+        }
+        if (pNode->bRaw && (Operation::Replace != aPatch.Op)) {
+            return false;
+        }
+        switch (aPatch.Op) {
+        case Operation::Insert:
+            if (aPatch.Path.back() > pNode->Children.size()) {
+                return false;
+            }
+            pNode->Children.insert(pNode->Children.begin() + static_cast<std::ptrdiff_t>(aPatch.Path.back()),
+                                   Node(aPatch.Value));
+            break;
+        case Operation::Remove:
+            if (aPatch.Path.back() >= pNode->Children.size()) {
+                return false;
+            }
+            pNode->Children.erase(pNode->Children.begin() + static_cast<std::ptrdiff_t>(aPatch.Path.back()));
+            break;
+        case Operation::Replace:
+            *pNode = Node(aPatch.Value);
+            break;
+        case Operation::Text:
+            pNode->Content = aPatch.Value;
+            break;
+        case Operation::SetAttribute:
+            pNode->Attributes[aPatch.Name] = aPatch.Value;
+            break;
+        case Operation::RemoveAttribute:
+            return 1 == pNode->Attributes.erase(aPatch.Name);
+        default:
+            return false;
+        }
+        return true;
+    }
+};
+
+/// Check that the patches computed by Diff turn the old tree into the new one
+bool checkDiff(const HTML::Element& aOld, const HTML::Element& aNew, const char* apPath) {
+    Node tree(aOld);
+    const std::vector<HTML::Diff::Patch> patches = HTML::Diff::compute(aOld, aNew);
+    for (size_t idx = 0; idx < patches.size(); ++idx) {
+        if (!tree.apply(patches[idx])) {
+            std::cerr << "Diff '" << apPath << "': patch " << idx << " cannot be applied to:\n"
+                      << serialize(aOld) << "\n----\n" << serialize(aNew) << std::endl;
+            return false;
+        }
+    }
+    if (!tree.equals(aNew)) {
+        std::cerr << "Diff '" << apPath << "': the " << patches.size() << " patches do not give the new tree:\n"
+                  << serialize(aOld) << "\n----\n" << serialize(aNew) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/// Build the trees described by the buffer, and render them through every available path
+bool run(const uint8_t* apData, const size_t aSize) {
+    bool bSuccess = true;
+    {
+        Generator generator(apData, aSize);
+        const HTML::Element element = generator.element();
+        const std::string reference = serialize(element);
+        bSuccess &= check(reference, element.toString(), "Element::toString");
+
+        std::ostringstream stream;
+        stream << element;
+        bSuccess &= check(reference, stream.str(), "std::ostream");
+
+        HTML::RenderContext context;
+        std::string output;
+        element.render(output, context);
+        element.render(output, context);
+        bSuccess &= check(reference + reference, output, "RenderContext");
+
+        // The generated texts are valid UTF-8, so they must be left untouched by the validation
+        context.Utf8 = HTML::RenderContext::Utf8Policy::Reject;
+        output.clear();
+        element.render(output, context);
+        bSuccess &= check(reference, output, "RenderContext UTF-8 validation");
+
+        HTML::Element copy(element);
+        bSuccess &= check(reference, copy.toString(), "copy");
+
+        bSuccess &= check(reference, HTML::Shared(HTML::share(std::move(copy))).toString(), "Shared");
+
+        const std::string image = HTML::Binary::save(element);
+        const HTML::Binary binary(image.data(), image.size());
+        bSuccess &= check(reference, binary.toString(), "Binary");
+        bSuccess &= check(reference, binary.load().toString(), "Binary::load");
+
+        // Diff to an unrelated tree, to the same one, and to a similar one built from the buffer with a byte changed
+        bSuccess &= checkDiff(element, generator.element(), "unrelated");
+        bSuccess &= checkDiff(element, element, "identical");
+        if (0 < aSize) {
+            std::vector<uint8_t> mutated(apData, apData + aSize);
+            ++mutated[mutated[0] % aSize];
+            Generator similar(mutated.data(), mutated.size());
+            bSuccess &= checkDiff(element, similar.element(), "similar");
+        }
+
+        // Variant of the shared tree modified at the end of a random path, against the same change on a full copy
+        const std::shared_ptr<const HTML::Element> pBase = HTML::share(HTML::Element(element));
+        HTML::Element variant = HTML::Shared(pBase);
+        HTML::Element expected(element);
+        HTML::Element* pVariant = &variant.unshare();
+        HTML::Element* pExpected = &expected.unshare();  // the generated root can be a Shared reference too
+        while (!pExpected->children().empty() && (0 < generator.pick(3))) {
+            const size_t idx = generator.pick(pExpected->children().size());
+            pVariant = &pVariant->child(idx);
+            pExpected = &pExpected->child(idx);
+        }
+        pVariant->addAttribute("data-variant", "1") << HTML::Span("variant");
+        pExpected->addAttribute("data-variant", "1") << HTML::Span("variant");
+        bSuccess &= check(serialize(expected), serialize(variant), "unshare");
+        bSuccess &= check(reference, pBase->toString(), "unshare base");
+
+        // Trees built again from the buffers recycled from the previous ones must not differ
+        HTML::NodePool pool;
+        for (size_t pass = 0; pass < 2; ++pass) {
+            Generator recycled(apData, aSize);
+            bSuccess &= check(reference, recycled.element().toString(), "NodePool");
+        }
+    }
+    {
+        Generator generator(apData, aSize);
+        HTML::Document document("Fuzz");
+        generator.document(document);
+        const std::string reference = "<!DOCTYPE html>" HTML_ENDLINE + serialize(document);
+        bSuccess &= check(reference, document.toString(), "Document::toString");
+
+        std::ostringstream stream;
+        stream << document;
+        bSuccess &= check(reference, stream.str(), "Document std::ostream");
+        bSuccess &= check(reference, static_cast<std::string>(document), "Document std::string");
+
+        const HTML::Element& root = document;
+        const HTML::Element before(root);
+        document.intern(1);
+        bSuccess &= check(reference, document.toString(), "Document intern");
+        const std::string image = HTML::Binary::save(document);
+        const HTML::Binary binary(image.data(), image.size());
+        bSuccess &= check(root.toString(), binary.toString(), "Document intern Binary");
+        bSuccess &= checkDiff(before, root, "Document intern");
+        if (!HTML::Diff::compute(before, root).empty()) {
+            std::cerr << "Diff of the interned Document is not empty" << std::endl;
+            bSuccess = false;
+        }
+    }
+    {
+        // The streamed CSV conversion must give the markup of the same Table built with Elements
+        Generator generator(apData, aSize);
+        const char delimiter = (0 < generator.pick(2)) ? ',' : '\t';
+        const size_t chunkSize = 1 + generator.pick(16);
+        const size_t depth = generator.pick(4);
+        const auto records = generator.records();
+        std::string csv;
+        HTML::Table table;
+        for (size_t idx = 0; idx < records.size(); ++idx) {
+            HTML::Row row;
+            for (size_t col = 0; col < records[idx].size(); ++col) {
+                const std::string& cell = records[idx][col];
+                csv += (0 < col) ? std::string(1, delimiter) : std::string();
+                if (cell.empty() && (1 == records[idx].size())) {
+                    csv += "\"\"";  // else an empty line, which is skipped
+                } else if (cell.find_first_of(std::string("\"\r\n") + delimiter) != std::string::npos) {
+                    csv += '"';
+                    for (const char c : cell) {
+                        csv += (c == '"') ? "\"\"" : std::string(1, c);
+                    }
+                    csv += '"';
+                } else {
+                    csv += cell;
+                }
+                std::string escaped;
+                for (const char c : cell) {
+                    escaped += (c == '&') ? "&amp;" : (c == '<') ? "&lt;" : (c == '>') ? "&gt;" : std::string(1, c);
+                }
+                if (0 == idx) {
+                    row << HTML::ColHeader(escaped);
+                } else {
+                    row << HTML::Col(escaped);
+                }
+            }
+            table << std::move(row);
+            csv += ((idx + 1 < records.size()) || (0 < generator.pick(2))) ? "\r\n" : "";
+        }
+        std::istringstream input(csv);
+        std::ostringstream output;
+        HTML::CsvTable(delimiter).chunkSize(chunkSize).depth(depth).convert(input, output);
+        std::ostringstream reference;
+        serialize(reference, table, depth * HTML_INDENTATION);
+        bSuccess &= check(reference.str(), output.str(), "CsvTable");
+    }
+    return bSuccess;
+}
+
+/// Process a very deep tree through every path walking the whole tree, none of which may recurse once per level
+bool runDeep() {
+    HTML::NodePool pool;  // destroying the tree then recycles the buffers of each node, level by level
+    bool bSuccess = true;
+    // Threaded comments: 10k levels of nested lists
+    HTML::Element deep = HTML::List() << HTML::ListItem("last");
+    for (size_t depth = 0; depth < 10000; ++depth) {
+        HTML::ListItem item("reply");
+        item.id("c" + std::to_string(depth)).style("margin:0") << std::move(deep);
+        deep = HTML::List() << std::move(item);
+    }
+    HTML::RenderContext context(0);  // without indentation, which would grow quadratically with the depth
+    std::string reference;
+    deep.render(reference, context);
+    const std::string image = HTML::Binary::save(deep);
+    std::string output;
+    HTML::Binary(image.data(), image.size()).render(output, context);
+    bSuccess &= check(reference, output, "deep Binary");
+
+    context.MaxDepth = 1000;
+    output.clear();
+    bool bThrown = false;
+    try {
+        deep.render(output, context);
+    } catch (const std::length_error&) {
+        bThrown = true;
+    }
+    if (!bThrown) {
+        std::cerr << "Rendering deeper than MaxDepth did not throw std::length_error" << std::endl;
+        bSuccess = false;
+    }
+    bThrown = false;
+    try {
+        HTML::Binary(image.data(), image.size()).render(output, context);
+    } catch (const std::length_error&) {
+        bThrown = true;
+    }
+    if (!bThrown) {
+        std::cerr << "Rendering a Binary deeper than MaxDepth did not throw std::length_error" << std::endl;
+        bSuccess = false;
+    }
+    context.MaxDepth = HTML_MAX_DEPTH;
+    output.clear();
+    HTML::Binary(image.data(), image.size()).load().render(output, context);
+    bSuccess &= check(reference, output, "deep Binary::load");
+
+    HTML::Element copy(deep);
+    output.clear();
+    copy.render(output, context);
+    bSuccess &= check(reference, output, "deep copy");
+    if (!HTML::Diff::compute(deep, copy).empty() || HTML::Diff::compute(deep, HTML::Div()).empty()) {
+        std::cerr << "Diff of the deep tree is wrong" << std::endl;
+        bSuccess = false;
+    }
+    const HTML::Index index(copy);
+    if (index.byId("c0") == nullptr) {
+        std::cerr << "Index of the deep tree is wrong" << std::endl;
+        bSuccess = false;
+    }
+    // Descendant combinators checked against every ancestor of every candidate, without memo, would never end
+    if (!index.select("ol ul li ul li ul li").empty() || (index.select("ul li ul li#c0 > ul li").size() != 1)
+        || (index.select("li ul li li ul > li").size() != 9998)) {
+        std::cerr << "Selecting in the deep tree is wrong" << std::endl;
+        bSuccess = false;
+    }
+
+    HTML::Document document("Deep");
+    document << std::move(copy);
+    document.intern(1);
+    document.hoistStyles();
+    output.clear();
+    document.render(output, context);
+    if (output.find("class=\"hb-0\"") == std::string::npos) {
+        std::cerr << "Hoisting the styles of the deep tree failed" << std::endl;
+        bSuccess = false;
+    }
+    return bSuccess;
+}
+
+/// Run the function on a thread with a stack of 256 KiB, far too small for one frame per level of a deep tree
+bool runOnSmallStack(bool (*apFunction)()) {
+#ifdef _WIN32
+    return apFunction();  // the stack of the main thread is 1 MiB on Windows
+#else
+    struct Call {
+        bool (*pFunction)();
+        bool bResult;
+    } call{apFunction, false};
+    pthread_attr_t attributes;
+    pthread_attr_init(&attributes);
+    pthread_attr_setstacksize(&attributes, 256 * 1024);
+    pthread_t thread;
+    const int error = pthread_create(&thread, &attributes, [](void* apCall) -> void* {
+        Call* pCall = static_cast<Call*>(apCall);
+        pCall->bResult = pCall->pFunction();
+        return nullptr;
+    }, &call);
+    pthread_attr_destroy(&attributes);
+    if (0 != error) {
+        std::cerr << "Cannot create a thread with a small stack" << std::endl;
+        return false;
+    }
+    pthread_join(thread, nullptr);
+    return call.bResult;
+#endif
+}
+
+/// Encode non-ASCII characters for an ASCII-only output, with the escapes of JavaScript and CSS in their raw texts
+bool runAsciiOnly() {
+    HTML::Document document("ASCII \xC3\xA9");
+    document.head() << HTML::Style("p::before { content: \"\xC3\xA9\"; }");
+    document << HTML::Paragraph("caf\xC3\xA9 \xF0\x9F\x98\x80").title("\xC3\xA9");
+    document << (HTML::Script(nullptr, "var s = \"\xC3\xA9\xF0\x9F\x98\x80\";").id("\xC3\xA9")
+                 << HTML::Text("// \xC3\xA9"));
+    document << HTML::Script(nullptr, "alert(\"\xFF\");");
+    HTML::RenderContext context;
+    context.AsciiOnly = true;
+    std::string output;
+    document.render(output, context);
+    const char* expected[] = {
+        "<title>ASCII &#xE9;</title>",
+        "<style>p::before { content: \"\\E9 \"; }</style>",
+        "<p title=\"&#xE9;\">caf&#xE9; &#x1F600;</p>",
+        "<script id=\"&#xE9;\">var s = \"\\u00E9\\uD83D\\uDE00\";",
+        "  // \\u00E9",
+        "<script>alert(\"\\uFFFD\");</script>",
+    };
+    bool bSuccess = true;
+    for (const char* pExpected : expected) {
+        if (output.find(pExpected) == std::string::npos) {
+            std::cerr << "ASCII-only output does not contain " << pExpected << ":\n" << output << std::endl;
+            bSuccess = false;
+        }
+    }
+    const std::string image = HTML::Binary::save(document);
+    std::string binary("<!DOCTYPE html>" HTML_ENDLINE);
+    HTML::Binary(image.data(), image.size()).render(binary, context);
+    bSuccess &= check(output, binary, "ASCII-only Binary");
+
+    context.AsciiOnly = false;
+    context.Utf8 = HTML::RenderContext::Utf8Policy::Replace;
+    output.clear();
+    document.render(output, context);
+    if (output.find("alert(\"\xEF\xBF\xBD\");") == std::string::npos) {
+        std::cerr << "Invalid UTF-8 is not replaced by U+FFFD:\n" << output << std::endl;
+        bSuccess = false;
+    }
+    return bSuccess;
+}
+
+/// Inline an image file as a data URL, then again after the file has changed
+bool runAssets() {
+    static const char sPath[] = "HtmlBuilder_fuzz_asset.png";
+    bool bSuccess = true;
+    const std::string bytes("\x89PNG\r\n\x1A\n\0\xFF", 10);
+    {
+        std::ofstream file(sPath, std::ios::binary);
+        file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+    const std::string image = HTML::ImageFile(sPath, "image/png", "logo").toString();
+    bSuccess &= (image.find("src=\"data:image/png;base64,iVBORw0KGgoA/w==\"") != std::string::npos);
+    bSuccess &= (*HTML::Asset::base64(sPath) == "iVBORw0KGgoA/w==") && (*HTML::Asset::content(sPath) == bytes);
+    {
+        std::ofstream file(sPath, std::ios::binary);
+        file.write("GIF89a", 6);
+    }
+    bSuccess &= (*HTML::Asset::dataUrl(sPath, "image/gif") == "data:image/gif;base64,R0lGODlh");
+    std::remove(sPath);
+    bSuccess &= HTML::Asset::content(sPath)->empty() && HTML::Asset::dataUrl(sPath, "image/gif")->empty();
+    if (!bSuccess) {
+        std::cerr << "Inlining an image file is wrong: " << image << std::endl;
+    }
+    return bSuccess;
+}
+
+/// Compute the Subresource Integrity of a script file, then again after the file has changed or been removed
+bool runIntegrity() {
+    static const char sPath[] = "HtmlBuilder_fuzz_integrity.js";
+    {
+        std::ofstream file(sPath, std::ios::binary);
+        file << "abc";
+    }
+    const std::string script = HTML::Script("app.js").integrityFromFile(sPath, HTML::Digest::Sha256).toString();
+    const std::string rel = HTML::Rel("preload", "app.js").integrityFromFile(sPath).toString();
+    static const char sSha256[] = "sha256-ungWv48Bz+pBQUDeXa4iI7ADYaOWF3qctBD/YfIAFa0=";
+    bool bSuccess = (script.find(std::string("integrity=\"") + sSha256 + '"') != std::string::npos);
+    bSuccess &= (rel.find("integrity=\"sha384-ywB1P0WjXou1oD1pmsZQBycsMqsO3tFjGotgWkP/W+2AhgcroefMI1i67KE0yCWn\"")
+                 != std::string::npos);
+    {
+        std::ofstream file(sPath, std::ios::binary);
+        file << "abcd";
+    }
+    bSuccess &= (*HTML::Asset::integrity(sPath, HTML::Digest::Sha256) != sSha256);
+    std::remove(sPath);
+    bSuccess &= (HTML::Script("app.js").integrityFromFile(sPath).toString().find("integrity") == std::string::npos);
+    if (!bSuccess) {
+        std::cerr << "Integrity of a file is wrong: " << script << rel << std::endl;
+    }
+    return bSuccess;
+}
+
+/// Split a dataset into pages sharing their Caption and header, with the pagination of each page
+bool runTablePages() {
+    HTML::TablePages pages([](const size_t aIndex) {
+        return HTML::Row() << HTML::Col("row" + std::to_string(aIndex));
+    }, 5, 2);
+    pages.caption(HTML::Caption("Data")).header(HTML::Row() << HTML::ColHeader("Value")).cls("data");
+    const auto url = [](const size_t aPage) { return "page" + std::to_string(aPage) + ".html"; };
+    bool bSuccess = (pages.nbPages() == 3) && (HTML::TablePages(nullptr, 0, 0).nbPages() == 0);
+    std::vector<std::string> tables;
+    std::vector<std::string> navs;
+    pages.forEachPage(url, [&tables, &navs](const size_t aPage, HTML::Table&& aTable, HTML::Nav&& aNav) {
+        tables.resize(aPage + 1);
+        navs.resize(aPage + 1);
+        tables[aPage] = aTable.toString();
+        navs[aPage] = aNav.toString();
+    });
+    bSuccess &= (tables.size() == 3) && (tables[1] == pages.table(1).toString());
+    const std::string expected =
+        "<table class=\"data\">" HTML_ENDLINE
+        "  <caption>Data</caption>" HTML_ENDLINE
+        "  <tr>" HTML_ENDLINE "    <th>Value</th>" HTML_ENDLINE "  </tr>" HTML_ENDLINE
+        "  <tr>" HTML_ENDLINE "    <td>row4</td>" HTML_ENDLINE "  </tr>" HTML_ENDLINE
+        "</table>" HTML_ENDLINE;
+    bSuccess &= (tables.size() == 3) && check(expected, tables[2], "TablePages last page");
+    bSuccess &= (tables[0].find("row1") != std::string::npos) && (tables[0].find("row2") == std::string::npos);
+    bSuccess &= (navs[0].find("Previous") == std::string::npos);
+    bSuccess &= (navs[0].find("<a href=\"page1.html\" class=\"page-link\">Next</a>") != std::string::npos);
+    bSuccess &= (navs[1].find("<li class=\"page-item active\">" HTML_ENDLINE
+                              "      <a href=\"page1.html\" class=\"page-link\">2</a>") != std::string::npos);
+    bSuccess &= (navs[2].find("<a href=\"page1.html\" class=\"page-link\">Previous</a>") != std::string::npos);
+    bSuccess &= (navs[2].find("Next") == std::string::npos);
+    if (!bSuccess) {
+        std::cerr << "Pages of a Table are wrong:\n" << tables[1] << navs[1] << std::endl;
+    }
+    return bSuccess;
+}
+
+/// Look up Elements by id, class and tag, and select them with compound selectors and combinators
+bool runIndex() {
+    HTML::Document document("Index");
+    HTML::Element table = HTML::Table().id("totals");
+    for (size_t line = 0; line < 3; ++line) {
+        const char* pClass = (0 < line) ? "total" : "total first";
+        table << (HTML::Row() << HTML::Col("item") << HTML::Col(std::to_string(line)).cls(pClass));
+    }
+    document << std::move(table);
+    document << (HTML::Div("wrapper") << (HTML::Paragraph("text") << HTML::Span("in p")) << HTML::Span("in div"));
+    const HTML::Index index(document);
+    const HTML::Element* pTable = index.byId("totals");
+    bool bSuccess = (pTable != nullptr) && (pTable->name() == "table") && (index.byId("none") == nullptr);
+    bSuccess &= (index.byClass("total").size() == 3) && (index.byClass("first").size() == 1);
+    bSuccess &= (index.byTag("td").size() == 6) && (index.byTag("span").size() == 2);
+    bSuccess &= (index.select("td.total").size() == 3) && (index.select("td.total.first").size() == 1);
+    bSuccess &= (index.select("#totals td").size() == 6) && (index.select("table#totals > td").empty());
+    bSuccess &= (index.select("tr > .total").size() == 3) && (index.select("body *").size() == 14);
+    const std::vector<HTML::Element*> spans = index.select("div.wrapper > span");
+    bSuccess &= (spans.size() == 1) && (spans.front()->content() == "in div");
+    bSuccess &= (index.select("div span").size() == 2) && (index.select("p > span").size() == 1);
+    bSuccess &= index.select("span p").empty() && index.select("table.wrapper").empty();
+    if (!bSuccess) {
+        std::cerr << "Lookups and selections of the Index are wrong" << std::endl;
+    }
+    return bSuccess;
+}
+
+/// Hoist the repeated styles of a Document twice, the second time after adding more Elements
+bool runHoistStyles() {
+    HTML::Document document("Styles");
+    for (size_t item = 0; item < 3; ++item) {
+        document << HTML::Paragraph("red").style("color:red");
+    }
+    document << HTML::Paragraph("once").style("color:blue");
+    document.hoistStyles();
+    const std::string first = document.toString();
+    document.hoistStyles();
+    bool bSuccess = (document.toString() == first);
+    document << HTML::Paragraph("red again").style("color:red");
+    document << HTML::Paragraph("margin").style("margin:0").cls("text");
+    document << HTML::Paragraph("margin").style("margin:0");
+    document.hoistStyles();
+    const std::string output = document.toString();
+    bSuccess &= (output.find("<style>.hb-0{color:red}.hb-1{margin:0}</style>") != std::string::npos);
+    bSuccess &= (output.find("<style>") == output.rfind("<style>"));
+    bSuccess &= (output.find("<p class=\"hb-0\">red again</p>") != std::string::npos);
+    bSuccess &= (output.find("<p class=\"text hb-1\">margin</p>") != std::string::npos);
+    bSuccess &= (output.find("style=\"color:red") == std::string::npos);
+    bSuccess &= (output.find("<p style=\"color:blue\">once</p>") != std::string::npos);
+    if (!bSuccess) {
+        std::cerr << "Hoisting styles twice is wrong:\n" << output << std::endl;
+    }
+    return bSuccess;
+}
+
+/// Keep handles to Elements while adding children, which moves the Elements where the pointers pointed to
+bool runHandles() {
+    HTML::Document document("Handles");
+    HTML::Element section = HTML::Div().id("section");
+    section << HTML::Paragraph("first").id("first");
+    document << std::move(section);
+    HTML::Index index(document);
+    const HTML::Index::Handle first = index.handleById("first");
+    const std::vector<HTML::Index::Handle> sections = index.handles("body > div#section");
+    bool bSuccess = (sections.size() == 1) && (index.get(index.handleById("none")) == nullptr);
+    for (size_t item = 0; item < 1000; ++item) {
+        document << HTML::Div("more");
+        *index.get(sections.front()) << HTML::Paragraph("more");
+    }
+    const HTML::Element* pFirst = index.get(first);
+    bSuccess &= (pFirst != nullptr) && (pFirst->content() == "first");
+    bSuccess &= (index.get(sections.front())->children().size() == 1001);
+    index.rebuild();
+    bSuccess &= (index.handleById("first") == first) && (index.select("div#section > p").size() == 1001);
+    document.clear();
+    bSuccess &= (index.get(first) == nullptr);
+    if (!bSuccess) {
+        std::cerr << "Handles to Elements are wrong after adding or removing children" << std::endl;
+    }
+    return bSuccess;
+}
+
+/// Intern two copies of a Document on two threads at the same time, each copy having its own intern pool
+bool runCopies() {
+    HTML::Document original("Copies");
+    for (size_t item = 0; item < 1000; ++item) {
+        original << HTML::Div("item").cls("interned-before-the-copy-" + std::to_string(item % 10));
+    }
+    original.intern();
+    for (size_t item = 0; item < 1000; ++item) {
+        original << HTML::Div("item").cls("interned-after-the-copy-" + std::to_string(item % 100));
+    }
+    const std::string reference = original.toString();
+    HTML::Document copies[2] = {original, original};
+#ifdef _WIN32
+    copies[0].intern();
+#else
+    pthread_t thread;
+    if (0 != pthread_create(&thread, nullptr, [](void* apDocument) -> void* {
+            static_cast<HTML::Document*>(apDocument)->intern();
+            return nullptr;
+        }, &copies[0])) {
+        std::cerr << "Cannot create a thread to intern a copy" << std::endl;
+        return false;
+    }
+#endif
+    copies[1].intern();
+    original.intern();
+#ifndef _WIN32
+    pthread_join(thread, nullptr);
+#endif
+    bool bSuccess = check(reference, copies[0].toString(), "Document copy intern");
+    bSuccess &= check(reference, copies[1].toString(), "Document copy intern");
+    bSuccess &= check(reference, original.toString(), "Document intern after copy");
+    return bSuccess;
+}
+
+/// Make variants of a large Document without copying it, each change copying only the path to the changed node
+bool runVariants() {
+    HTML::Document original("Variants");
+    for (size_t item = 0; item < 1000; ++item) {
+        original << (HTML::Div().cls("item") << HTML::Paragraph("item " + std::to_string(item)));
+    }
+    const std::string reference = original.toString();
+    const std::shared_ptr<const HTML::Element> pBase = HTML::share(std::move(original));
+    const HTML::Element& body = pBase->children()[1];
+
+    HTML::Document variant(pBase);
+    bool bSuccess = check(reference, variant.toString(), "Document variant");
+    // Only the <html>, <head> and <body> nodes are copied, the items of the <body> are still the original ones
+    bSuccess &= (variant.children()[1].shared() == nullptr)
+        && (variant.children()[1].children()[0].shared() == &body.children()[0]);
+    variant.body().child(500).child(0).cls("selected");
+    variant.head() << HTML::Meta("robots", "noindex");
+    const std::string output = variant.toString();
+    bSuccess &= (output.find("<p class=\"selected\">item 500</p>") != std::string::npos);
+    bSuccess &= (output.find("<meta name=\"robots\" content=\"noindex\">") != std::string::npos);
+    bSuccess &= check(reference, "<!DOCTYPE html>" HTML_ENDLINE + pBase->toString(), "Document variant base");
+    // Only the path html > body > div > p was copied: the other children are still the original ones
+    const std::vector<HTML::Element>& items = variant.children()[1].children();
+    bSuccess &= (items.size() == 1000) && (items[499].shared() == &body.children()[499]);
+    bSuccess &= (items[500].shared() == nullptr) && (items[500].children()[0].shared() == nullptr);
+
+    bool bThrown = false;
+    try {
+        HTML::Document invalid(HTML::share(HTML::Div()));
+    } catch (const std::invalid_argument&) {
+        bThrown = true;
+    }
+    if (!bSuccess || !bThrown) {
+        std::cerr << "Variants of a shared Document are wrong:\n" << output << std::endl;
+    }
+    return bSuccess && bThrown;
+}
+
+/// Process very deep and very wide trees, which must not be limited by the size of the stack
+bool runLarge() {
+    bool bSuccess = runOnSmallStack(runDeep);
+    {
+        // 1M children of a single Element
+        HTML::Element wide = HTML::Div();
+        wide.reserve(1000000);
+        for (size_t child = 0; child < 1000000; ++child) {
+            wide << HTML::Span("item");
+        }
+        const std::string reference = wide.toString();
+        const std::string image = HTML::Binary::save(wide);
+        bSuccess &= check(reference, HTML::Binary(image.data(), image.size()).toString(), "wide Binary");
+    }
+    return bSuccess;
+}
+
+} // namespace
+
+#ifdef HTML_LIBFUZZER
+
+/// Entry-point of the libFuzzer target
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* apData, size_t aSize) {
+    if (!run(apData, aSize)) {
+        std::abort();
+    }
+    return 0;
+}
+
+#else // HTML_LIBFUZZER
+
+/**
+ * @brief Entry-point of the offline fuzzing run.
+ *
+ * @param[in] argc  Number of arguments
+ * @param[in] argv  Optional seed and number of iterations
+ */
+int main(int argc, char* argv[]) {
+    const unsigned long seed = (1 < argc) ? std::strtoul(argv[1], nullptr, 10) : 0;
+    const unsigned long nbIterations = (2 < argc) ? std::strtoul(argv[2], nullptr, 10) : 1000;
+
+    if (!runLarge() || !runAssets() || !runIntegrity() || !runAsciiOnly() || !runHoistStyles() || !runHandles()
+        || !runCopies() || !runTablePages() || !runIndex() || !runVariants()) {
+        return 1;
+    }
+
+    std::mt19937 random(static_cast<std::mt19937::result_type>(seed));
+    std::vector<uint8_t> data;
+    for (unsigned long iteration = 0; iteration < nbIterations; ++iteration) {
+        data.resize(random() % 512);
+        for (auto& byte : data) {
+            byte = static_cast<uint8_t>(random());
+        }
+        if (!run(data.data(), data.size())) {
+            std::cerr << "Failure at iteration " << iteration << " with seed " << seed << std::endl;
+            return 1;
+        }
+    }
+    std::cout << nbIterations << " random trees rendered identically through every path" << std::endl;
+    return 0;
+}
+
+#endif // HTML_LIBFUZZER
@@ -0,0 +1,18 @@
+/**
+ * @file    HtmlBuilder.cpp
+ * @ingroup HtmlBuilder
+ * @brief   Compiled HtmlBuilder library, as an alternative to the header-only mode to speed up builds.
+ *
+ *   Define HTML_COMPILED_LIBRARY when including the HTML headers to link with this library:
+ * the serialization is then compiled only once here instead of in each translation unit.
+ *
+ * Copyright (c) 2017-2021 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+ *
+ * Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+ * or copy at http://opensource.org/licenses/MIT)
+ */
+
+#include <HTML/HTML.h>
+
+#include <HTML/Element.inl>
+#include <HTML/Document.inl>